@@ -0,0 +1,111 @@
+#include "sxui.h"
+#include <math.h>
+#include <stdio.h>
+
+// Compares the path rasterizer against the usual way of building filled
+// shapes out of many short line segments. Run headless with
+// SDL_VIDEODRIVER=dummy (see `make bench-path`).
+
+#define CANVAS_W 1000
+#define CANVAS_H 600
+#define ITERATIONS 300
+#define WAVE_POINTS 500
+#define STROKE_WIDTH 8
+
+static SXLine lines[CANVAS_W * STROKE_WIDTH];
+static SDL_FPoint poly[WAVE_POINTS * 2 + 2];
+
+static float wave(float x, int frame) {
+    return CANVAS_H / 2 + 200.0f * sinf(x * 0.02f + frame * 0.1f);
+}
+
+static double now_ms(void) {
+    return SDL_GetPerformanceCounter() * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+static void report(const char* name, double segments_ms, double path_ms) {
+    printf("%-14s segments %7.3f ms   path %7.3f ms   (%.2fx)\n",
+           name, segments_ms / ITERATIONS, path_ms / ITERATIONS, segments_ms / path_ms);
+}
+
+int main(void) {
+    sxui_init("Path Benchmark", 320, 240, 0x4A90E2FF);
+    UIElement* canvas = sxui_canvas(NULL, 0, 0, CANVAS_W, CANVAS_H);
+    UIPath* path = sxui_path_new();
+
+    // Area chart: one vertical segment per column vs a single polygon.
+    double t0 = now_ms();
+    for (int f = 0; f < ITERATIONS; f++) {
+        for (int x = 0; x < CANVAS_W; x++)
+            lines[x] = (SXLine){x, (int)wave(x, f), x, CANVAS_H - 1, 0x3366FFFF};
+        sxui_canvas_draw_lines(canvas, lines, CANVAS_W);
+    }
+    double t1 = now_ms();
+    for (int f = 0; f < ITERATIONS; f++) {
+        sxui_path_reset(path);
+        sxui_path_move_to(path, 0, CANVAS_H);
+        for (int x = 0; x < CANVAS_W; x += 2)
+            sxui_path_line_to(path, x, wave(x, f));
+        sxui_path_line_to(path, CANVAS_W, CANVAS_H);
+        sxui_path_close(path);
+        sxui_canvas_fill_path(canvas, path, 0x3366FFFF, UI_FILL_NONZERO);
+    }
+    double t2 = now_ms();
+    report("area chart", t1 - t0, t2 - t1);
+
+    // Thick wave: the polyline stacked STROKE_WIDTH times vs one outline polygon.
+    // The segments win here: they are aliased, while the polygon has to
+    // resolve coverage along ~2000px of edge for a band only 8px tall, so
+    // almost every pixel it touches is a partial-coverage blend.
+    int step = CANVAS_W / WAVE_POINTS;
+    t0 = now_ms();
+    for (int f = 0; f < ITERATIONS; f++) {
+        int n = 0;
+        for (int o = 0; o < STROKE_WIDTH; o++) {
+            for (int x = 0; x + step < CANVAS_W; x += step) {
+                lines[n++] = (SXLine){x, (int)wave(x, f) + o, x + step, (int)wave(x + step, f) + o, 0xFF6633FF};
+            }
+        }
+        sxui_canvas_draw_lines(canvas, lines, n);
+    }
+    t1 = now_ms();
+    for (int f = 0; f < ITERATIONS; f++) {
+        int n = 0;
+        for (int x = 0; x < CANVAS_W; x += step)
+            poly[n++] = (SDL_FPoint){x, wave(x, f)};
+        for (int x = CANVAS_W - step; x >= 0; x -= step)
+            poly[n++] = (SDL_FPoint){x, wave(x, f) + STROKE_WIDTH};
+        sxui_canvas_fill_polygon(canvas, poly, n, 0xFF6633FF, UI_FILL_NONZERO);
+    }
+    t2 = now_ms();
+    report("thick wave", t1 - t0, t2 - t1);
+
+    // Disc: horizontal spans per row vs four cubic Beziers.
+    const float cx = CANVAS_W / 2, cy = CANVAS_H / 2, r = 250, k = 0.5522847f * r;
+    t0 = now_ms();
+    for (int f = 0; f < ITERATIONS; f++) {
+        int n = 0;
+        for (int y = (int)(cy - r); y <= (int)(cy + r); y++) {
+            int dx = (int)sqrtf(r * r - (y - cy) * (y - cy));
+            lines[n++] = (SXLine){(int)cx - dx, y, (int)cx + dx, y, 0x33CC66FF};
+        }
+        sxui_canvas_draw_lines(canvas, lines, n);
+    }
+    t1 = now_ms();
+    for (int f = 0; f < ITERATIONS; f++) {
+        sxui_path_reset(path);
+        sxui_path_move_to(path, cx + r, cy);
+        sxui_path_cubic_to(path, cx + r, cy + k, cx + k, cy + r, cx, cy + r);
+        sxui_path_cubic_to(path, cx - k, cy + r, cx - r, cy + k, cx - r, cy);
+        sxui_path_cubic_to(path, cx - r, cy - k, cx - k, cy - r, cx, cy - r);
+        sxui_path_cubic_to(path, cx + k, cy - r, cx + r, cy - k, cx + r, cy);
+        sxui_path_close(path);
+        sxui_canvas_fill_path(canvas, path, 0x33CC66FF, UI_FILL_NONZERO);
+    }
+    t2 = now_ms();
+    report("disc", t1 - t0, t2 - t1);
+
+    sxui_path_free(path);
+    sxui_cleanup();
+    return 0;
+}
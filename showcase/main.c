@@ -10,6 +10,7 @@ static UIElement *page_list[8];
 static UIElement *sidebar_el;
 static UIElement *exit_btn;
 static int sidebar_collapsed = 0;
+static int profiler_visible = 0;
 int corner_radius = 25;
 int esc_to_exit = 1;
 
@@ -48,7 +49,7 @@ static void on_nav_click(void *element) {
 static void on_toggle_sidebar(void *el) {
   sidebar_collapsed = !sidebar_collapsed;
   int w = sidebar_collapsed ? 70 : 240;
-  sxui_set_size(sidebar_el, w, 800);
+  sxui_set_size(sidebar_el, w, sxui_get_height(sidebar_el));
 
   const char *labels_full[] = {"Dashboard",    "Editor",    "Canvas Lab",
                                "Paint",        "File Drop", "Stress Test",
@@ -73,12 +74,10 @@ static void on_toggle_sidebar(void *el) {
     }
   }
 
+  // Pages are anchored to all four window edges; only the left margin moves.
   for (int i = 0; i < 8; i++) {
-    if (page_list[i]) {
-      sxui_set_position(page_list[i], w, 0);
-      sxui_set_size(page_list[i], 1280 - w, 800);
-      sxui_frame_update_layout(page_list[i]);
-    }
+    if (page_list[i])
+      sxui_set_anchor_margins(page_list[i], w, 0, 0, 0);
   }
 }
 
@@ -87,11 +86,59 @@ static void quit_app(void *el) {
   sxui_quit();
 }
 
+// Frame times collected during --replay (see `make bench-replay`).
+static double *frame_ms = NULL;
+static int frame_count = 0, frame_cap = 0;
+
+static void add_frame_time(double ms) {
+  if (frame_count == frame_cap) {
+    int cap = frame_cap ? frame_cap * 2 : 1024;
+    double *grown = realloc(frame_ms, cap * sizeof(double));
+    if (!grown)
+      return;
+    frame_ms = grown;
+    frame_cap = cap;
+  }
+  frame_ms[frame_count++] = ms;
+}
+
+static int cmp_double(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+static void report_frame_times(const char *session) {
+  if (frame_count == 0) {
+    printf("%s: no frames\n", session);
+    return;
+  }
+  double total = 0;
+  for (int i = 0; i < frame_count; i++)
+    total += frame_ms[i];
+  qsort(frame_ms, frame_count, sizeof(double), cmp_double);
+  printf("%s: %d frames  mean %.3f ms  p50 %.3f  p95 %.3f  p99 %.3f  max %.3f\n",
+         session, frame_count, total / frame_count,
+         frame_ms[frame_count / 2], frame_ms[frame_count * 95 / 100],
+         frame_ms[frame_count * 99 / 100], frame_ms[frame_count - 1]);
+}
+
 int main(int argc, char *argv[]) {
-  (void)argc;
-  (void)argv;
+  const char *record_path = NULL;
+  const char *replay_path = NULL;
+  for (int i = 1; i + 1 < argc; i++) {
+    if (strcmp(argv[i], "--record") == 0)
+      record_path = argv[++i];
+    else if (strcmp(argv[i], "--replay") == 0)
+      replay_path = argv[++i];
+  }
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--low-latency") == 0)
+      sxui_set_low_latency(1);
+  }
+
   sxui_init("SXUI Technical Showcase", 1280, 800, current_seed);
   sxui_set_theme(current_seed, current_mode);
+  sxui_set_resizable(1);
 
   sidebar_el =
       sxui_frame(NULL, 0, 0, 240, 800, UI_LAYOUT_VERTICAL | UI_FLAG_NONE);
@@ -99,6 +146,7 @@ int main(int argc, char *argv[]) {
   sxui_frame_set_padding(sidebar_el, 10);
   sxui_frame_set_spacing(sidebar_el, 10);
   sxui_frame_set_default_child_size(sidebar_el, 220, 50);
+  sxui_set_anchors(sidebar_el, UI_ANCHOR_LEFT | UI_ANCHOR_TOP | UI_ANCHOR_BOTTOM);
 
   sidebar_title = sxui_label(sidebar_el, "SXUI SHOWCASE");
   UIElement *toggle =
@@ -129,17 +177,33 @@ int main(int argc, char *argv[]) {
   page_list[6] = create_gradient_lab_page(NULL);
   page_list[7] = create_input_lab_page(NULL);
 
-  for (int i = 0; i < 8; i++)
+  for (int i = 0; i < 8; i++) {
+    sxui_set_anchors(page_list[i], UI_ANCHOR_ALL);
     sxui_add_page(page_list[i]);
+  }
 
   sxui_switch_page(0);
 
-  while (!sxui_should_quit()) {
+  if (record_path && !sxui_record_begin(record_path))
+    fprintf(stderr, "Could not record to %s\n", record_path);
+  if (replay_path && !sxui_replay(replay_path)) {
+    fprintf(stderr, "Could not replay %s\n", replay_path);
+    sxui_cleanup();
+    return 1;
+  }
+
+  while (!sxui_should_quit() && (!replay_path || sxui_is_replaying())) {
+    Uint64 frame_start = SDL_GetPerformanceCounter();
     sxui_poll_events();
 
     if (esc_to_exit && sxui_is_key_pressed(SX_KEY_ESCAPE)) {
       sxui_quit();
     }
+    // F3 shows input-to-present latency per event kind.
+    if (sxui_is_key_pressed(SDL_SCANCODE_F3)) {
+      profiler_visible = !profiler_visible;
+      sxui_set_profiler_overlay(profiler_visible);
+    }
 
     int cp = sxui_get_current_page();
     if (cp == 2) {
@@ -151,8 +215,14 @@ int main(int argc, char *argv[]) {
     }
 
     sxui_render();
+    if (replay_path)
+      add_frame_time((SDL_GetPerformanceCounter() - frame_start) * 1000.0 /
+                     SDL_GetPerformanceFrequency());
   }
 
+  if (replay_path)
+    report_frame_times(replay_path);
+  free(frame_ms);
   sxui_cleanup();
   return 0;
 }
@@ -1,96 +1,169 @@
 #include "../../sxui.h"
 #include <math.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 
-#define MAX_PARTICLES 60
+#define PARTICLE_COUNT 20000
 
-typedef struct {
-  float x, y;
-  float vx, vy;
-  Uint32 color;
-} Particle;
-
-static Particle particles[MAX_PARTICLES];
-static int particles_init = 0;
 static float phase = 0;
-static int current_anim = 0; // 0=Sine, 1=Particles
+static int current_anim = 0; // 0=Sine, 1=Particles, 2=Paths
 
 static void draw_sine_wave(UIElement *canvas) {
+  static SXLine segments[512];
   int cw = sxui_get_width(canvas), ch = sxui_get_height(canvas);
+  int n = 0;
   phase += 0.05f;
   int last_y = ch / 2;
-  for (int i = 0; i < cw; i += 8) {
+  for (int i = 0; i < cw && n < 512; i += 8) {
     int y = ch / 2 + (int)(sinf(phase + i * 0.01f) * 80 * sinf(phase * 0.2f));
-    sxui_canvas_draw_line(canvas, i - 8 > 0 ? i - 8 : 0, last_y, i, y,
-                          0x00FF7AFF);
+    segments[n++] = (SXLine){i - 8 > 0 ? i - 8 : 0, last_y, i, y, 0x00FF7AFF};
     last_y = y;
   }
+  sxui_canvas_draw_lines(canvas, segments, n);
+}
+
+static UIElement *particle_field = NULL;
+
+// The particle mode runs on a particle element instead of the canvas: the
+// system integrates and draws itself, and the spatial hash colours each
+// particle by how crowded its neighbourhood is.
+static void seed_particles(UIElement *field) {
+  int cw = sxui_get_width(field), ch = sxui_get_height(field);
+  srand(time(NULL));
+  for (int i = 0; i < PARTICLE_COUNT; i++)
+    sxui_particles_emit(field, rand() % cw, rand() % ch,
+                        (rand() % 100 - 50) * 1.5f, (rand() % 100 - 50) * 1.5f,
+                        3, 0x4A90E2FF);
+}
+
+static void update_particles(UIElement *field) {
+  static int neighbours[64];
+  sxui_particles_update(field, 1.0f / 60);
+  SXParticles d = sxui_particles_data(field);
+  for (int i = 0; i < d.count; i++) {
+    int n = sxui_particles_query(field, d.x[i], d.y[i], 12, neighbours, 64);
+    int heat = n * 24 > 255 ? 255 : n * 24;
+    d.color[i] = (Uint32)heat << 24 | (Uint32)(144 + heat / 3) << 16 |
+                 (Uint32)(226 - heat * 3 / 4) << 8 | 0xFF;
+  }
 }
 
-static void draw_particles(UIElement *canvas) {
+static void draw_paths(UIElement *canvas) {
+  static UIPath *path = NULL;
+  if (!path)
+    path = sxui_path_new();
   int cw = sxui_get_width(canvas), ch = sxui_get_height(canvas);
-  if (!particles_init) {
-    srand(time(NULL));
-    for (int i = 0; i < MAX_PARTICLES; i++) {
-      particles[i].x = rand() % cw;
-      particles[i].y = rand() % ch;
-      particles[i].vx = (rand() % 100 - 50) / 40.0f;
-      particles[i].vy = (rand() % 100 - 50) / 40.0f;
-      particles[i].color = (rand() % 0xFFFFFF) << 8 | 0xFF;
-    }
-    particles_init = 1;
+  phase += 0.02f;
+
+  // Breathing blob built from cubic segments.
+  float cx = cw * 0.3f, cy = ch * 0.5f;
+  sxui_path_reset(path);
+  for (int i = 0; i < 6; i++) {
+    float a0 = phase + i * (float)M_PI / 3, a1 = a0 + (float)M_PI / 3;
+    float r0 = 160 + 30 * sinf(phase * 3 + i);
+    float r1 = 160 + 30 * sinf(phase * 3 + i + 1);
+    if (i == 0)
+      sxui_path_move_to(path, cx + cosf(a0) * r0, cy + sinf(a0) * r0);
+    sxui_path_cubic_to(path, cx + cosf(a0 + 0.4f) * 220,
+                       cy + sinf(a0 + 0.4f) * 220, cx + cosf(a1 - 0.4f) * 220,
+                       cy + sinf(a1 - 0.4f) * 220, cx + cosf(a1) * r1,
+                       cy + sinf(a1) * r1);
+  }
+  sxui_path_close(path);
+  sxui_canvas_fill_path(canvas, path, 0x4A90E2CC, UI_FILL_NONZERO);
+
+  // Self-intersecting star: the even-odd rule leaves the pentagon open.
+  cx = cw * 0.72f;
+  sxui_path_reset(path);
+  for (int i = 0; i < 5; i++) {
+    float a = -phase - (float)M_PI / 2 + i * 4 * (float)M_PI / 5;
+    if (i == 0)
+      sxui_path_move_to(path, cx + cosf(a) * 200, cy + sinf(a) * 200);
+    else
+      sxui_path_line_to(path, cx + cosf(a) * 200, cy + sinf(a) * 200);
   }
+  sxui_path_close(path);
+  sxui_canvas_fill_path(canvas, path, 0xFFB300FF, UI_FILL_EVENODD);
+}
+
+static UIElement *lab_canvas = NULL;
+static int fx_layer = 0;
 
-  for (int i = 0; i < MAX_PARTICLES; i++) {
-    particles[i].x += particles[i].vx;
-    particles[i].y += particles[i].vy;
-
-    if (particles[i].x < 0 || particles[i].x > cw)
-      particles[i].vx *= -1;
-    if (particles[i].y < 0 || particles[i].y > ch)
-      particles[i].vy *= -1;
-
-    sxui_canvas_draw_circle(canvas, (int)particles[i].x, (int)particles[i].y, 2,
-                            particles[i].color, 1);
-
-    for (int j = i + 1; j < MAX_PARTICLES; j++) {
-      float dx = particles[i].x - particles[j].x;
-      if (fabsf(dx) > 50)
-        continue;
-      float dy = particles[i].y - particles[j].y;
-      if (fabsf(dy) > 50)
-        continue;
-
-      float dist_sq = dx * dx + dy * dy;
-      if (dist_sq < 2500) {
-        sxui_canvas_draw_line(canvas, (int)particles[i].x, (int)particles[i].y,
-                              (int)particles[j].x, (int)particles[j].y,
-                              0x33333366);
-      }
-    }
+// The background and grid live on layer 0 and are drawn once; each frame
+// only clears and redraws the transparent "fx" layer above it.
+static void draw_background(UIElement *canvas) {
+  static SXLine grid[64];
+  int cw = sxui_get_width(canvas), ch = sxui_get_height(canvas);
+  int n = 0;
+  for (int x = 0; x < cw && n < 64; x += 50)
+    grid[n++] = (SXLine){x, 0, x, ch - 1, 0x151515FF};
+  for (int y = 0; y < ch && n < 64; y += 50)
+    grid[n++] = (SXLine){0, y, cw - 1, y, 0x151515FF};
+  sxui_canvas_clear(canvas, 0x050505FF);
+  sxui_canvas_draw_lines(canvas, grid, n);
+
+  char label[16];
+  for (int x = 100; x < cw; x += 100) {
+    snprintf(label, sizeof(label), "%d", x);
+    sxui_canvas_draw_text(canvas, x + 4, ch - 22, label, 0x555555FF, NULL);
+  }
+  for (int y = 100; y < ch; y += 100) {
+    snprintf(label, sizeof(label), "%d", y);
+    sxui_canvas_draw_text(canvas, 4, y + 2, label, 0x555555FF, NULL);
   }
 }
 
 static void update_canvas(UIElement *canvas) {
-  sxui_canvas_clear(canvas, 0x050505FF);
+  sxui_canvas_select_layer(canvas, fx_layer);
+  sxui_canvas_clear(canvas, 0x00000000);
   if (current_anim == 0)
     draw_sine_wave(canvas);
-  else
-    draw_particles(canvas);
+  else if (current_anim == 2)
+    draw_paths(canvas);
 }
 
-static UIElement *lab_canvas = NULL;
+static UIElement *strip_chart = NULL;
+static int strip_last_y = -1;
+
+// Frame interval telemetry: each frame scrolls the ring by two columns and
+// draws only the newest columns instead of redrawing the whole trace.
+static void update_strip_chart(UIElement *chart) {
+  static Uint32 last_ticks = 0;
+  Uint32 now = sxui_get_ticks();
+  int ch = sxui_get_height(chart), cw = sxui_get_width(chart);
+  int ms = last_ticks ? (int)(now - last_ticks) : 16;
+  last_ticks = now;
+
+  int y = ch - 1 - ms * (ch - 1) / 50;
+  if (y < 0)
+    y = 0;
+  if (strip_last_y < 0)
+    strip_last_y = y;
+  sxui_canvas_scroll(chart, 2, 0x0A0A0AFF);
+  int x = sxui_canvas_scroll_x(chart, cw - 1);
+  sxui_canvas_draw_line(chart, x - 1, ch - 1 - 16 * (ch - 1) / 50, x, ch - 1 - 16 * (ch - 1) / 50,
+                        0x333333FF);
+  // x - 2 may fall off the left of the buffer; the canvas wraps it.
+  sxui_canvas_draw_line(chart, x - 2, strip_last_y, x, y, 0x00FF7AFF);
+  strip_last_y = y;
+}
 
 void update_canvas_lab_animation(void) {
-  if (lab_canvas)
+  if (current_anim == 1 && particle_field)
+    update_particles(particle_field);
+  else if (lab_canvas)
     update_canvas(lab_canvas);
+  if (strip_chart)
+    update_strip_chart(strip_chart);
 }
 
 static void on_anim_change(void *el, int index, const char *val) {
   (void)el;
   (void)val;
   current_anim = index;
+  sxui_set_visible(lab_canvas, index != 1);
+  sxui_set_visible(particle_field, index == 1);
 }
 
 UIElement *create_canvas_lab_page(UIElement *parent) {
@@ -100,14 +173,29 @@ UIElement *create_canvas_lab_page(UIElement *parent) {
 
   lab_canvas = sxui_canvas(page, 0, 0, 1000, 600);
   sxui_set_outline(lab_canvas, 1, 0x333333FF, 255);
-
-  UIElement *toolbar = sxui_frame(page, 0, 0, 1000, 60, UI_LAYOUT_HORIZONTAL);
+  draw_background(lab_canvas);
+  fx_layer = sxui_canvas_add_layer(lab_canvas, "fx");
+
+  particle_field = sxui_particles(page, 0, 0, 1000, 600);
+  sxui_particles_set_cell_size(particle_field, 12);
+  seed_particles(particle_field);
+  sxui_set_visible(lab_canvas, current_anim != 1);
+  sxui_set_visible(particle_field, current_anim == 1);
+
+  UIElement *toolbar =
+      sxui_frame(page, 0, 0, 1000, 60, UI_LAYOUT_FLEX | UI_LAYOUT_HORIZONTAL);
+  sxui_frame_set_align(toolbar, UI_FLEX_ALIGN_CENTER);
   sxui_label(toolbar, "SELECT ANIMATION:");
-  UIElement *dd =
-      sxui_dropdown(toolbar, (const char *[]){"Sine Wave", "Atom Particles"}, 2,
-                    current_anim);
+  UIElement *dd = sxui_dropdown(
+      toolbar,
+      (const char *[]){"Sine Wave", "Atom Particles", "Vector Paths"}, 3,
+      current_anim);
   sxui_set_size(dd, 200, 40);
   sxui_on_dropdown_changed(dd, on_anim_change);
 
+  strip_chart = sxui_canvas(page, 0, 0, 1000, 60);
+  sxui_canvas_clear(strip_chart, 0x0A0A0AFF);
+  sxui_canvas_set_scrolling(strip_chart, 1);
+
   return page;
 }
@@ -6,8 +6,9 @@
 
 static UIElement *paint_canvas;
 static Uint32 current_color = 0xFF0000FF;
-static int current_tool = 0; // 0=Brush, 1=Rect, 2=Circle
+static int current_tool = 0; // 0=Brush, 1=Rect, 2=Circle, 3=Bucket
 static int last_pencil_x = -1, last_pencil_y = -1;
+static int bucket_armed = 1;
 
 static void on_tool_brush(void *el) {
   (void)el;
@@ -21,18 +22,32 @@ static void on_tool_circle(void *el) {
   (void)el;
   current_tool = 2;
 }
+static void on_tool_bucket(void *el) {
+  (void)el;
+  current_tool = 3;
+}
 static void on_clear_canvas(void *el) {
   (void)el;
   sxui_canvas_clear(paint_canvas, 0xFFFFFFFF);
+  sxui_canvas_checkpoint(paint_canvas);
+}
+static void on_undo(void *el) {
+  (void)el;
+  sxui_canvas_undo(paint_canvas);
+}
+static void on_redo(void *el) {
+  (void)el;
+  sxui_canvas_redo(paint_canvas);
 }
 
 void update_paint_animation(void) {
   if (!paint_canvas)
     return;
 
+  // SXUI's input state rather than SDL's, so replayed sessions paint too.
   int mx, my;
-  Uint32 buttons = SDL_GetMouseState(&mx, &my);
-  if (buttons & SDL_BUTTON(SDL_BUTTON_LEFT)) {
+  sxui_get_mouse_pos(&mx, &my);
+  if (sxui_is_mouse_button_down(SX_MOUSE_LEFT)) {
     int sb_w = get_sidebar_width();
     int lx = mx - sb_w;
     int ly = my - 60;
@@ -58,22 +73,31 @@ void update_paint_animation(void) {
       }
       last_pencil_x = lx;
       last_pencil_y = ly;
+    } else if (current_tool == 3) {
+      // One fill per press, not one per frame while the button is held.
+      if (bucket_armed && lx < 1040 && ly < 740)
+        sxui_canvas_flood_fill(paint_canvas, lx, ly, current_color, 32);
+      bucket_armed = 0;
     } else {
       last_pencil_x = -1; // Reset for shape tools
       static Uint32 last_shape_t = 0;
-      if (SDL_GetTicks() - last_shape_t > 150) {
+      if (sxui_get_ticks() - last_shape_t > 150) {
         if (current_tool == 1) {
           sxui_canvas_draw_rect(paint_canvas, lx - 40, ly - 30, 80, 60,
                                 current_color, 0);
         } else if (current_tool == 2) {
           sxui_canvas_draw_circle(paint_canvas, lx, ly, 40, current_color, 0);
         }
-        last_shape_t = SDL_GetTicks();
+        last_shape_t = sxui_get_ticks();
       }
     }
   } else {
+    // Each press-drag-release becomes one undo step; this is a no-op when
+    // nothing was drawn since the last checkpoint.
+    sxui_canvas_checkpoint(paint_canvas);
     last_pencil_x = -1;
     last_pencil_y = -1;
+    bucket_armed = 1;
   }
 }
 
@@ -115,12 +139,16 @@ UIElement *create_paint_page(UIElement *parent) {
   sxui_frame_set_padding(toolbar, 10);
   sxui_frame_set_spacing(toolbar, 10);
 
-  sxui_button(toolbar, "BRUSH", on_tool_brush);
+  // Tool buttons and the label size themselves to their text.
+  sxui_set_auto_size(sxui_button(toolbar, "BRUSH", on_tool_brush), 1);
+  sxui_set_auto_size(sxui_button(toolbar, "BUCKET", on_tool_bucket), 1);
   // sxui_button(toolbar, "RECT", on_tool_rect);
   // sxui_button(toolbar, "CIRCLE", on_tool_circle);
-  sxui_button(toolbar, "CLEAR", on_clear_canvas);
+  sxui_set_auto_size(sxui_button(toolbar, "CLEAR", on_clear_canvas), 1);
+  sxui_set_auto_size(sxui_button(toolbar, "UNDO", on_undo), 1);
+  sxui_set_auto_size(sxui_button(toolbar, "REDO", on_redo), 1);
 
-  sxui_label(toolbar, " COLORS:");
+  sxui_set_auto_size(sxui_label(toolbar, " COLORS:"), 1);
   sxui_set_size(sxui_button(toolbar, "BLACK", on_color), 50, 50);
   sxui_set_size(sxui_button(toolbar, "RED", on_color), 50, 50);
   sxui_set_size(sxui_button(toolbar, "GREEN", on_color), 50, 50);
@@ -136,6 +164,7 @@ UIElement *create_paint_page(UIElement *parent) {
 
   paint_canvas = sxui_canvas(page, 0, 0, 1040, 740);
   sxui_canvas_clear(paint_canvas, 0xFFFFFFFF);
+  sxui_canvas_set_history(paint_canvas, 32 * 1024 * 1024);
 
   return page;
 }
@@ -4,8 +4,22 @@
 #include <string.h>
 #include <math.h>
 #include <ctype.h>
+#include <limits.h>
 #include "dynamic_list.h"
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SXUI_SSE2
+#endif
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SXUI_MMAP
+#endif
+
 #define INPUT_MAX 256
 #define SCROLL_FADE_MS 1500
 #define DROPDOWN_Z_INDEX 10000
@@ -28,10 +42,12 @@ typedef struct {
     UIThemeMode mode;
 } UITheme;
 
-typedef struct {
-    int id;
-    void* callback;
-} BoundCallback;
+typedef struct UIHandlers UIHandlers;
+
+typedef struct UIFlexItem UIFlexItem;
+typedef struct UIConstraint UIConstraint;
+typedef struct UITextSize UITextSize;
+typedef struct UIHitIndex UIHitIndex;
 
 struct UIElement {
 <<<<<<< HEAD
@@ -42,7 +58,6 @@ struct UIElement {
     UIElement* parent;
     list* children;
     int _is_hovered;
-    int _is_hovered_prev;
     int _is_dragging;
     int z_index;
     Uint32 creation_time;
@@ -50,9 +65,13 @@ struct UIElement {
     Uint32 custom_color;
     int has_custom_color;
     UIEffects effects;
+    UIFlexItem* flex;
+    UIConstraint* constraint;
+    UITextSize* text_size;
+    UIHitIndex* hits;
     
-    list* onMouseEnter;
-    list* onMouseLeave;
+    UIHandlers* onMouseEnter;
+    UIHandlers* onMouseLeave;
 =======
   int x, y, w, h;
   int target_w, target_h;
@@ -61,7 +80,6 @@ struct UIElement {
   UIElement *parent;
   list *children;
   int _is_hovered;
-  int _is_hovered_prev;
   int _is_dragging;
   int z_index;
   Uint32 creation_time;
@@ -69,17 +87,21 @@ struct UIElement {
   Uint32 custom_color;
   int has_custom_color;
   UIEffects effects;
-
-  list *onMouseEnter;
-  list *onMouseLeave;
-  list *onMouseClick;
+  UIFlexItem *flex;
+  UIConstraint *constraint;
+  UITextSize *text_size;
+  UIHitIndex *hits;
+
+  UIHandlers *onMouseEnter;
+  UIHandlers *onMouseLeave;
+  UIHandlers *onMouseClick;
 >>>>>>> 410878f (feat: Add new pages and enhance input handling)
 };
 
 typedef struct {
     UIElement el;
     char* text;
-    list* onClick;
+    UIHandlers* onClick;
     int _pressed;
     Uint32 _lastClickTime;
 } UIButton;
@@ -97,22 +119,22 @@ typedef struct {
     int scrollOffset;
     int cursorPosition;
     int selectionAnchor;
-    list* onFocusChanged;
-    list* onTextChanged;
-    list* onSubmit;
+    UIHandlers* onFocusChanged;
+    UIHandlers* onTextChanged;
+    UIHandlers* onSubmit;
 } UITextInput;
 
 typedef struct {
     UIElement el;
     int value;
     char* text;
-    list* onValueChanged;
+    UIHandlers* onValueChanged;
 } UICheckBox;
 
 typedef struct {
     UIElement el;
     float value;
-    list* onValueChanged;
+    UIHandlers* onValueChanged;
 } UISlider;
 
 typedef struct {
@@ -121,23 +143,109 @@ typedef struct {
     int option_count;
     int selected_index;
     int is_open;
-    list* onSelectionChanged;
+    UIHandlers* onSelectionChanged;
 } UIDropdown;
 
+typedef struct UICanvasHistory UICanvasHistory;
+typedef struct CanvasLayer CanvasLayer;
+typedef struct CanvasTiles CanvasTiles;
+typedef struct CanvasMapping CanvasMapping;
+
 typedef struct {
     UIElement el;
     SDL_Texture* texture;
     Uint32* pixels;
     int pitch;
+    int dirty;
+    int dirty_x1, dirty_y1, dirty_x2, dirty_y2;
+    Uint32* buffers[3];
+    int back, front;
+    SDL_atomic_t ready;
+    UICanvasHistory* history;
+    CanvasLayer* layers;
+    int layer_count, layer_cap, active_layer;
+    Uint32* composite;
+    CanvasTiles* tiles;
+    CanvasMapping* mapped;
+    int ring, ring_head;
 } UICanvas;
 
+typedef struct {
+    UIElement el;
+    float *x, *y, *vx, *vy, *size;
+    Uint32* color;
+    int count, capacity;
+    UIParticleEdge edge;
+    SDL_Texture* texture;
+    float cell;
+    int cols, rows;
+    int* cell_start;
+    int* cell_items;
+    int* cell_of;
+    float *cell_x, *cell_y;
+    int grid_cells, grid_items, grid_valid;
+    SDL_Vertex* verts;
+    int* indices;
+    int vertex_cap;
+} UIParticles;
+
+#define FLEX_CACHE_SLOTS 4
+
+// Per-child flex settings, allocated on first use. The measure cache holds
+// the last few sizes computed, keyed by the available space they were
+// computed under: a container is measured by its parent and then laid out
+// at its final size, so one slot would thrash between the two.
+struct UIFlexItem {
+    float grow, shrink;
+    int basis;
+    int pref_w, pref_h;
+    int min_w, min_h, max_w, max_h;
+    UIFlexAlign align_self;
+    int text_w, text_h;
+    int cached, cache_next;
+    struct { int avail_w, avail_h, w, h; } cache[FLEX_CACHE_SLOTS];
+};
+
+// Anchored edges keep their distance to the same edge of the parent (the
+// window for root elements); centred axes keep their offset from the
+// parent's centre. Left and top double as the centre offsets. Anchored
+// elements are positioned by their constraints, not by the parent's layout.
+struct UIConstraint {
+    int anchors;
+    int left, top, right, bottom;
+    float pct_w, pct_h;
+    int parent_w, parent_h;
+};
+
+// Intrinsic size of a text widget, measured from its text and padding and
+// kept until one of those or the font changes. Auto-sized widgets take it
+// as their size; flex layouts use it to measure any text widget.
+struct UITextSize {
+    int enabled;
+    int pad_x, pad_y;
+    int w, h;
+    int valid;
+};
+
+typedef struct UIVirtualList UIVirtualList;
+
 typedef struct {
     UIElement el;
     int padding, spacing;
     int scroll_y, content_height;
+    int scroll_x, content_width;
+    float scroll_fx, scroll_fy;
+    float scroll_vx, scroll_vy;
+    int snap_x, snap_y;
+    int scroll_moving;
     Uint32 last_scroll_time;
     int max_grid_cols;
     int scroll_bar_width;
+    int layout_dirty, layout_from, layout_count;
+    int layout_cx, layout_cy, layout_row_h, layout_cols;
+    UIFlexJustify justify;
+    UIFlexAlign align;
+    UIVirtualList* virt;
 } UIFrame;
 
 typedef struct {
@@ -192,7 +300,27 @@ typedef struct {
 } SXUI_Engine;
 
 static SXUI_Engine engine;
-static int GLOBAL_CONN_ID = 0;
+static void _glyph_cache_drop(TTF_Font* font);
+static list* dirty_frames = NULL;
+static void _layout_frame(UIFrame* f);
+static void _layout_invalidate(UIElement* frame, int from);
+static void _layout_invalidate_child(UIElement* child);
+static void _layout_resized(UIElement* el);
+static void _flex_layout(UIFrame* f);
+static void _flex_free(UIElement* el);
+static int layout_running = 0;
+static list* constrained = NULL;
+static int constraints_dirty = 0;
+static void _constraints_apply(void);
+static void _constraint_free(UIElement* el);
+static void _text_size_free(UIElement* el);
+static void _text_size_changed(UIElement* el);
+static void _text_size_font_changed(void);
+static list* virtual_lists = NULL;
+static void _vlist_sync(UIFrame* f);
+static void _vlists_sync(void);
+static void _vlist_free(UIFrame* f);
+static void _hit_invalidate(UIElement* container);
 
 <<<<<<< HEAD
 TTF_Font* _get_active_font() {
@@ -455,147 +583,397 @@ void _draw_text(const char* text, int x, int y, Uint32 c, int center, int pass)
     SDL_FreeSurface(s);
 }
 
-UIConnection bind_event(list* handler_list, void* callback) {
-    BoundCallback* bc = malloc(sizeof(BoundCallback));
-    bc->id = ++GLOBAL_CONN_ID;
-    bc->callback = callback;
-    list_add(handler_list, bc);
-    
-    UIConnection conn;
-    conn.id = bc->id;
-    conn.parent_list = handler_list;
+// --- Handlers ---
+// Every binding takes a slot in one global slab; a UIConnection is the slot
+// number plus the generation it was issued with, so disconnecting is a
+// direct lookup and stale handles are ignored. Each element/event pair owns
+// a chain, allocated on first bind, holding callbacks in a contiguous array.
+// Disconnected entries are cleared in place and squeezed out once no
+// dispatch is walking the chain.
+
+struct UIHandlers {
+    struct {
+        void* callback;
+        int slot;
+    }* entries;
+    int count, cap;
+    int dead;
+    int dispatching;
+};
+
+typedef struct {
+    UIHandlers* chain;
+    int index;
+    Uint32 generation;
+    int next_free;
+} HandlerSlot;
+
+static HandlerSlot* handler_slots = NULL;
+static int handler_slot_count = 0, handler_slot_cap = 0;
+static int handler_free = -1;
+
+static int _handler_slot_take(void) {
+    if (handler_free >= 0) {
+        int slot = handler_free;
+        handler_free = handler_slots[slot].next_free;
+        return slot;
+    }
+    if (handler_slot_count == handler_slot_cap) {
+        int cap = handler_slot_cap ? handler_slot_cap * 2 : 64;
+        HandlerSlot* slots = realloc(handler_slots, cap * sizeof(HandlerSlot));
+        if (!slots) return -1;
+        handler_slots = slots;
+        handler_slot_cap = cap;
+    }
+    handler_slots[handler_slot_count].generation = 1;
+    return handler_slot_count++;
+}
+
+static void _handler_slot_release(int slot) {
+    HandlerSlot* s = &handler_slots[slot];
+    s->chain = NULL;
+    s->generation++;
+    s->next_free = handler_free;
+    handler_free = slot;
+}
+
+static void _handlers_compact(UIHandlers* h) {
+    int n = 0;
+    for (int i = 0; i < h->count; i++) {
+        if (!h->entries[i].callback) continue;
+        h->entries[n] = h->entries[i];
+        handler_slots[h->entries[n].slot].index = n;
+        n++;
+    }
+    h->count = n;
+    h->dead = 0;
+}
+
+static void _handlers_free(UIHandlers* h) {
+    if (!h) return;
+    for (int i = 0; i < h->count; i++) {
+        if (h->entries[i].callback) _handler_slot_release(h->entries[i].slot);
+    }
+    free(h->entries);
+    free(h);
+}
+
+// Returns the next live callback, or NULL once the chain is exhausted. Start
+// with *i = 0 and always run to the end so the dispatch count stays balanced.
+static void* _handlers_next(UIHandlers* h, int* i) {
+    if (!h) return NULL;
+    if (*i == 0) h->dispatching++;
+    while (*i < h->count) {
+        void* cb = h->entries[(*i)++].callback;
+        if (cb) return cb;
+    }
+    if (--h->dispatching == 0 && h->dead) _handlers_compact(h);
+    return NULL;
+}
+
+UIConnection bind_event(UIHandlers** chain, void* callback) {
+    UIConnection none = {0, 0};
+    UIHandlers* h = *chain;
+    if (!h) {
+        h = calloc(1, sizeof(UIHandlers));
+        if (!h) return none;
+        *chain = h;
+    }
+    if (h->dead && !h->dispatching) _handlers_compact(h);
+    if (h->count == h->cap) {
+        int cap = h->cap ? h->cap * 2 : 2;
+        void* entries = realloc(h->entries, cap * sizeof(*h->entries));
+        if (!entries) return none;
+        h->entries = entries;
+        h->cap = cap;
+    }
+    int slot = _handler_slot_take();
+    if (slot < 0) return none;
+
+    handler_slots[slot].chain = h;
+    handler_slots[slot].index = h->count;
+    h->entries[h->count].callback = callback;
+    h->entries[h->count].slot = slot;
+    h->count++;
+
+    UIConnection conn = {slot + 1, handler_slots[slot].generation};
     return conn;
 }
 
 void disconnect_binding(UIConnection conn) {
-    if (!conn.parent_list) return;
-    for (size_t i = 0; i < list_length(conn.parent_list); i++) {
-        BoundCallback* bc = (BoundCallback*)list_get(conn.parent_list, i);
-        if (bc->id == conn.id) {
-            list_remove_at(conn.parent_list, i);
-            free(bc);
-            return;
+    int slot = conn.slot - 1;
+    if (slot < 0 || slot >= handler_slot_count) return;
+    HandlerSlot* s = &handler_slots[slot];
+    if (!s->chain || s->generation != conn.generation) return;
+    s->chain->entries[s->index].callback = NULL;
+    s->chain->dead++;
+    if (!s->chain->dispatching && s->chain->dead * 2 > s->chain->count) _handlers_compact(s->chain);
+    _handler_slot_release(slot);
+}
+
+// --- Event Queue ---
+// sxui_poll_events only records what input did to which element; callbacks
+// run from _events_dispatch once the batch has been read, so no handler ever
+// runs while the poll loop is holding hit-test results or walking the tree.
+// Deletes requested by those handlers wait for the end of the batch.
+typedef enum {
+    EVENT_CLICK,
+    EVENT_MOUSE_CLICK,
+    EVENT_FOCUS,
+    EVENT_HOVER,
+    EVENT_TEXT_CHANGED,
+    EVENT_SUBMIT,
+    EVENT_VALUE_CHANGED,
+    EVENT_DROPDOWN_CHANGED,
+    EVENT_FILE_DROP
+} QueuedEventType;
+
+typedef struct {
+    QueuedEventType type;
+    void* element;
+    int arg;
+    float value;
+    char* file;
+    Uint32 timestamp;
+} QueuedEvent;
+
+static QueuedEvent* event_queue = NULL;
+static int event_count = 0, event_cap = 0;
+static int event_batching = 0;
+static int event_dispatching = 0;
+static Uint32 event_time = 0;   // SDL timestamp of the input being handled
+static UIElement** pending_deletes = NULL;
+static int pending_delete_count = 0, pending_delete_cap = 0;
+
+void trigger_click(UIButton* btn);
+void trigger_mouse_click(UIElement* el, int button);
+void trigger_focus(UITextInput* input, int focused);
+void trigger_hover(UIElement* elem, int hovered);
+void trigger_text_changed(UITextInput* input);
+void trigger_submit(UITextInput* input);
+void trigger_value_changed(void* element, float value);
+void trigger_dropdown_changed(UIDropdown* dd, int index, const char* value);
+
+// Returns the queued slot, or NULL when the caller should fire in place
+// (outside a poll, or the queue could not grow).
+static QueuedEvent* _event_push(QueuedEventType type, void* element, int arg, float value) {
+    if (!event_batching) return NULL;
+    if (event_count == event_cap) {
+        int cap = event_cap ? event_cap * 2 : 64;
+        QueuedEvent* q = realloc(event_queue, cap * sizeof(QueuedEvent));
+        if (!q) return NULL;
+        event_queue = q;
+        event_cap = cap;
+    }
+    QueuedEvent* ev = &event_queue[event_count++];
+    memset(ev, 0, sizeof(*ev));
+    ev->type = type;
+    ev->element = element;
+    ev->arg = arg;
+    ev->value = value;
+    ev->timestamp = event_time;
+    return ev;
+}
+
+static int _delete_pending(UIElement* el) {
+    for (; el; el = el->parent) {
+        for (int i = 0; i < pending_delete_count; i++) {
+            if (pending_deletes[i] == el) return 1;
+        }
+    }
+    return 0;
+}
+
+static int _delete_defer(UIElement* el) {
+    if (!event_dispatching) return 0;
+    if (_delete_pending(el)) return 1;
+    if (pending_delete_count == pending_delete_cap) {
+        int cap = pending_delete_cap ? pending_delete_cap * 2 : 16;
+        UIElement** d = realloc(pending_deletes, cap * sizeof(UIElement*));
+        if (!d) return 0;
+        pending_deletes = d;
+        pending_delete_cap = cap;
+    }
+    pending_deletes[pending_delete_count++] = el;
+    return 1;
+}
+
+static void _deletes_flush(void) {
+    // Drop entries inside another pending subtree before anything is freed,
+    // since deleting the ancestor takes them with it.
+    for (int i = 0; i < pending_delete_count; i++) {
+        for (UIElement* p = pending_deletes[i]->parent; p; p = p->parent) {
+            int covered = 0;
+            for (int j = 0; j < pending_delete_count; j++) {
+                if (pending_deletes[j] == p) covered = 1;
+            }
+            if (covered) {
+                pending_deletes[i] = pending_deletes[--pending_delete_count];
+                i--;
+                break;
+            }
+        }
+    }
+    int count = pending_delete_count;
+    pending_delete_count = 0;
+    for (int i = 0; i < count; i++) sxui_delete(pending_deletes[i]);
+}
+
+static void _events_dispatch(void) {
+    event_batching = 0;
+    event_dispatching = 1;
+    for (int i = 0; i < event_count; i++) {
+        QueuedEvent* ev = &event_queue[i];
+        event_time = ev->timestamp;
+        if (_delete_pending(ev->element)) {
+            if (ev->file) SDL_free(ev->file);
+            continue;
+        }
+        switch (ev->type) {
+            case EVENT_CLICK: trigger_click(ev->element); break;
+            case EVENT_MOUSE_CLICK: trigger_mouse_click(ev->element, ev->arg); break;
+            case EVENT_FOCUS: trigger_focus(ev->element, ev->arg); break;
+            case EVENT_HOVER: trigger_hover(ev->element, ev->arg); break;
+            case EVENT_TEXT_CHANGED: trigger_text_changed(ev->element); break;
+            case EVENT_SUBMIT: trigger_submit(ev->element); break;
+            case EVENT_VALUE_CHANGED: trigger_value_changed(ev->element, ev->value); break;
+            case EVENT_DROPDOWN_CHANGED: {
+                UIDropdown* dd = ev->element;
+                // An earlier handler in the batch may have replaced the options.
+                if (ev->arg < dd->option_count) trigger_dropdown_changed(dd, ev->arg, dd->options[ev->arg]);
+                break;
+            }
+            case EVENT_FILE_DROP:
+                if (engine.file_drop_callback) engine.file_drop_callback(ev->element, ev->file);
+                SDL_free(ev->file);
+                break;
         }
     }
+    event_count = 0;
+    event_dispatching = 0;
+    event_time = 0;
+    _deletes_flush();
+}
+
+Uint32 sxui_get_event_timestamp(void) {
+    return event_time;
 }
 
 <<<<<<< HEAD
 void trigger_click(UIButton* btn) {
-    for (size_t i = 0; i < list_length(btn->onClick); i++) {
-        BoundCallback* bc = (BoundCallback*)list_get(btn->onClick, i);
-        ((ClickCallback)bc->callback)(btn);
+    void* cb;
+    if (_event_push(EVENT_CLICK, btn, 0, 0)) return;
+    for (int i = 0; (cb = _handlers_next(btn->onClick, &i));) ((ClickCallback)cb)(btn);
 =======
 void trigger_click(UIButton *btn) {
-  if (btn && btn->onClick) {
-    for (size_t i = 0; i < list_length(btn->onClick); i++) {
-      BoundCallback *bc = list_get(btn->onClick, i);
-      ((ClickCallback)bc->callback)(btn);
-    }
-  }
+  void *cb;
+  if (_event_push(EVENT_CLICK, btn, 0, 0))
+    return;
+  if (btn)
+    for (int i = 0; (cb = _handlers_next(btn->onClick, &i));)
+      ((ClickCallback)cb)(btn);
 }
 
 void trigger_mouse_click(UIElement *el, int button) {
-  if (el && el->onMouseClick) {
-    for (size_t i = 0; i < list_length(el->onMouseClick); i++) {
-      BoundCallback *bc = list_get(el->onMouseClick, i);
-      ((void (*)(UIElement *, int))bc->callback)(el, button);
-    }
-  }
+  void *cb;
+  if (_event_push(EVENT_MOUSE_CLICK, el, button, 0))
+    return;
+  if (el)
+    for (int i = 0; (cb = _handlers_next(el->onMouseClick, &i));)
+      ((void (*)(UIElement *, int))cb)(el, button);
 }
 void trigger_focus(UITextInput *input, int focused) {
-  for (size_t i = 0; i < list_length(input->onFocusChanged); i++) {
-    BoundCallback *bc = (BoundCallback *)list_get(input->onFocusChanged, i);
-    ((FocusCallback)bc->callback)(input, focused);
-  }
+  void *cb;
+  if (_event_push(EVENT_FOCUS, input, focused, 0))
+    return;
+  for (int i = 0; (cb = _handlers_next(input->onFocusChanged, &i));)
+    ((FocusCallback)cb)(input, focused);
 }
 
 void trigger_hover(UIElement *elem, int hovered) {
-  list *l = hovered ? elem->onMouseEnter : elem->onMouseLeave;
-  for (size_t i = 0; i < list_length(l); i++) {
-    BoundCallback *bc = (BoundCallback *)list_get(l, i);
-    ((HoverCallback)bc->callback)(elem, hovered);
-  }
+  if (_event_push(EVENT_HOVER, elem, hovered, 0))
+    return;
+  UIHandlers *h = hovered ? elem->onMouseEnter : elem->onMouseLeave;
+  void *cb;
+  for (int i = 0; (cb = _handlers_next(h, &i));)
+    ((HoverCallback)cb)(elem, hovered);
 }
 
 void trigger_text_changed(UITextInput *input) {
-  for (size_t i = 0; i < list_length(input->onTextChanged); i++) {
-    BoundCallback *bc = (BoundCallback *)list_get(input->onTextChanged, i);
-    ((TextCallback)bc->callback)(input, input->text);
-  }
+  void *cb;
+  if (_event_push(EVENT_TEXT_CHANGED, input, 0, 0))
+    return;
+  for (int i = 0; (cb = _handlers_next(input->onTextChanged, &i));)
+    ((TextCallback)cb)(input, input->text);
 }
 
 void trigger_submit(UITextInput *input) {
-  for (size_t i = 0; i < list_length(input->onSubmit); i++) {
-    BoundCallback *bc = (BoundCallback *)list_get(input->onSubmit, i);
-    ((TextCallback)bc->callback)(input, input->text);
-  }
+  void *cb;
+  if (_event_push(EVENT_SUBMIT, input, 0, 0))
+    return;
+  for (int i = 0; (cb = _handlers_next(input->onSubmit, &i));)
+    ((TextCallback)cb)(input, input->text);
 }
 
 void trigger_value_changed(void *element, float value) {
-  list *handlers = NULL;
+  if (_event_push(EVENT_VALUE_CHANGED, element, 0, value))
+    return;
+  UIHandlers *handlers = NULL;
   if (((UIElement *)element)->type == UI_SLIDER) {
     handlers = ((UISlider *)element)->onValueChanged;
   } else if (((UIElement *)element)->type == UI_CHECKBOX) {
     handlers = ((UICheckBox *)element)->onValueChanged;
   }
 
-  if (handlers) {
-    for (size_t i = 0; i < list_length(handlers); i++) {
-      BoundCallback *bc = (BoundCallback *)list_get(handlers, i);
-      ((ValueCallback)bc->callback)(element, value);
+  void *cb;
+  for (int i = 0; (cb = _handlers_next(handlers, &i));) {
+    ((ValueCallback)cb)(element, value);
 >>>>>>> 410878f (feat: Add new pages and enhance input handling)
-    }
 }
 
 void trigger_focus(UITextInput* input, int focused) {
-    for (size_t i = 0; i < list_length(input->onFocusChanged); i++) {
-        BoundCallback* bc = (BoundCallback*)list_get(input->onFocusChanged, i);
-        ((FocusCallback)bc->callback)(input, focused);
-    }
+    void* cb;
+    if (_event_push(EVENT_FOCUS, input, focused, 0)) return;
+    for (int i = 0; (cb = _handlers_next(input->onFocusChanged, &i));) ((FocusCallback)cb)(input, focused);
 }
 
 void trigger_hover(UIElement* elem, int hovered) {
-    list* l = hovered ? elem->onMouseEnter : elem->onMouseLeave;
-    for (size_t i = 0; i < list_length(l); i++) {
-        BoundCallback* bc = (BoundCallback*)list_get(l, i);
-        ((HoverCallback)bc->callback)(elem, hovered);
-    }
+    if (_event_push(EVENT_HOVER, elem, hovered, 0)) return;
+    UIHandlers* h = hovered ? elem->onMouseEnter : elem->onMouseLeave;
+    void* cb;
+    for (int i = 0; (cb = _handlers_next(h, &i));) ((HoverCallback)cb)(elem, hovered);
 }
 
 void trigger_text_changed(UITextInput* input) {
-    for (size_t i = 0; i < list_length(input->onTextChanged); i++) {
-        BoundCallback* bc = (BoundCallback*)list_get(input->onTextChanged, i);
-        ((TextCallback)bc->callback)(input, input->text);
-    }
+    void* cb;
+    if (_event_push(EVENT_TEXT_CHANGED, input, 0, 0)) return;
+    for (int i = 0; (cb = _handlers_next(input->onTextChanged, &i));) ((TextCallback)cb)(input, input->text);
 }
 
 void trigger_submit(UITextInput* input) {
-    for (size_t i = 0; i < list_length(input->onSubmit); i++) {
-        BoundCallback* bc = (BoundCallback*)list_get(input->onSubmit, i);
-        ((TextCallback)bc->callback)(input, input->text);
-    }
+    void* cb;
+    if (_event_push(EVENT_SUBMIT, input, 0, 0)) return;
+    for (int i = 0; (cb = _handlers_next(input->onSubmit, &i));) ((TextCallback)cb)(input, input->text);
 }
 
 void trigger_value_changed(void* element, float value) {
-    list* handlers = NULL;
+    if (_event_push(EVENT_VALUE_CHANGED, element, 0, value)) return;
+    UIHandlers* handlers = NULL;
     if (((UIElement*)element)->type == UI_SLIDER) {
         handlers = ((UISlider*)element)->onValueChanged;
     } else if (((UIElement*)element)->type == UI_CHECKBOX) {
         handlers = ((UICheckBox*)element)->onValueChanged;
     }
     
-    if (handlers) {
-        for (size_t i = 0; i < list_length(handlers); i++) {
-            BoundCallback* bc = (BoundCallback*)list_get(handlers, i);
-            ((ValueCallback)bc->callback)(element, value);
-        }
-    }
+    void* cb;
+    for (int i = 0; (cb = _handlers_next(handlers, &i));) ((ValueCallback)cb)(element, value);
 }
 
 void trigger_dropdown_changed(UIDropdown* dd, int index, const char* value) {
-    for (size_t i = 0; i < list_length(dd->onSelectionChanged); i++) {
-        BoundCallback* bc = (BoundCallback*)list_get(dd->onSelectionChanged, i);
-        ((DropdownCallback)bc->callback)(dd, index, value);
+    void* cb;
+    if (_event_push(EVENT_DROPDOWN_CHANGED, dd, index, 0)) return;
+    for (int i = 0; (cb = _handlers_next(dd->onSelectionChanged, &i));) {
+        ((DropdownCallback)cb)(dd, index, value);
     }
 }
 
@@ -824,43 +1202,12 @@ void read_input(UITextInput* input, SDL_Event* event) {
 
 void sx_update_layout(UIFrame *f) {
   if (!(f->el.flags &
-        (UI_LAYOUT_VERTICAL | UI_LAYOUT_HORIZONTAL | UI_LAYOUT_GRID))) {
+        (UI_LAYOUT_VERTICAL | UI_LAYOUT_HORIZONTAL | UI_LAYOUT_GRID |
+         UI_LAYOUT_FLEX))) {
     return;
   }
-  int cx = f->padding, cy = f->padding;
-  int max_row_h = 0;
-  int col_count = 0;
-
-  for (size_t i = 0; i < list_length(f->el.children); i++) {
-    UIElement *c = list_get(f->el.children, i);
-    if (c->flags & UI_FLAG_HIDDEN)
-      continue;
-
-    if (c->w == 0)
-      c->w = (f->el.target_w > 0) ? f->el.target_w : 100;
-    if (c->h == 0)
-      c->h = (f->el.target_h > 0) ? f->el.target_h : 30;
-
-    if (f->el.flags & UI_LAYOUT_GRID) {
-      if (cx + c->w + f->padding > f->el.w ||
-          (f->max_grid_cols > 0 && col_count >= f->max_grid_cols)) {
-        cx = f->padding;
-        cy += max_row_h + f->spacing;
-        max_row_h = 0;
-        col_count = 0;
-      }
-      c->x = cx;
-      c->y = cy;
-      cx += c->w + f->spacing;
-      if (c->h > max_row_h)
-        max_row_h = c->h;
-      col_count++;
-    } else if (f->el.flags & UI_LAYOUT_HORIZONTAL) {
-      c->x = cx;
-      c->y = cy;
-      cx += c->w + f->spacing;
-      if (c->h > max_row_h)
-        max_row_h = c->h;
+  _layout_frame(f);
+}
 >>>>>>> 410878f (feat: Add new pages and enhance input handling)
     } else {
         cx = _measure_text_len(input->text, input->cursorPosition);
@@ -887,13 +1234,48 @@ void sx_update_layout(UIFrame *f) {
 }
 
 void sx_update_layout(UIFrame* f) {
+    _layout_frame(f);
+}
+
+// Lays out the children of one frame. When the only change since the last
+// pass is children appended at the end, the flow cursor saved by that pass
+// is resumed, so building a frame child by child stays linear.
+static int _is_laid_out(UIElement* el) {
+    return !(el->flags & UI_FLAG_HIDDEN) && !(el->constraint && el->constraint->anchors);
+}
+
+static void _layout_frame(UIFrame* f) {
+    _hit_invalidate(&f->el);
+    if (f->virt) {
+        _vlist_sync(f);
+        f->layout_from = INT_MAX;
+        return;
+    }
+    if (f->el.flags & UI_LAYOUT_FLEX) {
+        _flex_layout(f);
+        f->layout_count = 0;
+        f->layout_from = INT_MAX;
+        return;
+    }
+
+    int n = list_length(f->el.children);
+    int i = 0;
     int cx = f->padding, cy = f->padding;
     int max_row_h = 0;
     int col_count = 0;
 
-    for (size_t i = 0; i < list_length(f->el.children); i++) {
+    if (f->layout_count > 0 && f->layout_from >= f->layout_count && f->layout_count <= n) {
+        i = f->layout_count;
+        cx = f->layout_cx;
+        cy = f->layout_cy;
+        max_row_h = f->layout_row_h;
+        col_count = f->layout_cols;
+    }
+
+    if (i == 0) f->content_width = 0;
+    for (; i < n; i++) {
         UIElement* c = list_get(f->el.children, i);
-        if (c->flags & UI_FLAG_HIDDEN) continue;
+        if (!_is_laid_out(c)) continue;
 
         if (c->w == 0) c->w = (f->el.target_w > 0) ? f->el.target_w : 100;
         if (c->h == 0) c->h = (f->el.target_h > 0) ? f->el.target_h : 30;
@@ -921,1464 +1303,6250 @@ void sx_update_layout(UIFrame* f) {
             c->y = cy;
             cy += c->h + f->spacing;
         }
+        if (c->x + c->w + f->padding > f->content_width) f->content_width = c->x + c->w + f->padding;
     }
     f->content_height = cy + max_row_h + f->padding;
-}
 
-int compare_elements_desc(const void* a, const void* b) {
-    UIElement* ea = *(UIElement**)a;
-    UIElement* eb = *(UIElement**)b;
-    
-    if (ea->z_index != eb->z_index) {
-        return eb->z_index - ea->z_index;
+    f->layout_count = n;
+    f->layout_cx = cx;
+    f->layout_cy = cy;
+    f->layout_row_h = max_row_h;
+    f->layout_cols = col_count;
+    f->layout_from = INT_MAX;
+}
+
+static int _is_flex_frame(UIElement* el) {
+    return el && el->type == UI_FRAME && (el->flags & UI_LAYOUT_FLEX);
+}
+
+static void _layout_queue(UIFrame* f, int from) {
+    if (from < f->layout_from) f->layout_from = from;
+    if (f->layout_dirty) return;
+    f->layout_dirty = 1;
+    if (!dirty_frames) dirty_frames = list_new();
+    list_add(dirty_frames, f);
+}
+
+// Mutations only record the first child index that changed and queue the
+// frame; sxui_layout_flush lays out each queued frame once. A flex frame's
+// measured size depends on its children, so the change also drops the
+// measure cache of every flex frame up the chain and queues each of them.
+// Resizes made by a layout pass itself are not mutations.
+static void _layout_invalidate(UIElement* frame, int from) {
+    _hit_invalidate(frame);
+    if (layout_running || !frame || frame->type != UI_FRAME) return;
+    _layout_queue((UIFrame*)frame, from);
+    for (UIElement* p = frame; _is_flex_frame(p); p = p->parent) {
+        if (p->flex) p->flex->cached = 0;
+        if (_is_flex_frame(p->parent)) _layout_queue((UIFrame*)p->parent, 0);
     }
-    
-    return (int)(eb->creation_time - ea->creation_time);
 }
 
-UIElement* _get_hit(list* l, int mx, int my, int px, int py) {
-    int count = list_length(l);
-    if (count == 0) return NULL;
+// Children are usually resized right after being added, so the search runs
+// from the back and an append-then-resize still resumes the saved cursor.
+static void _layout_invalidate_child(UIElement* child) {
+    _hit_invalidate(child->parent);
+    if (layout_running) return;
+    if (child->flex) child->flex->cached = 0;
+    UIElement* p = child->parent;
+    if (!p || p->type != UI_FRAME) return;
+    int i = list_length(p->children) - 1;
+    while (i > 0 && list_get(p->children, i) != child) i--;
+    _layout_invalidate(p, i);
+}
+
+// An explicit resize also becomes the element's preferred flex size, and
+// any constrained children are refitted on the next flush.
+static void _layout_resized(UIElement* el) {
+    _hit_invalidate(el->parent);
+    if (constrained) constraints_dirty = 1;
+    if (layout_running) return;
+    if (el->flex) {
+        el->flex->pref_w = el->w;
+        el->flex->pref_h = el->h;
+    }
+    _layout_invalidate(el, 0);
+    _layout_invalidate_child(el);
+}
+
+// Layout can resize frames that constrained children depend on, and
+// constraints can resize laid-out elements, so the two alternate until
+// neither has work left. Constraints skip elements whose parent size did not
+// change, so a settled pass is cheap; the cap stops rules that keep fighting.
+#define LAYOUT_MAX_PASSES 4
+
+void sxui_layout_flush(void) {
+    for (int pass = 0; pass < LAYOUT_MAX_PASSES; pass++) {
+        if (constraints_dirty) _constraints_apply();
+        _vlists_sync();
+        if (!dirty_frames || list_length(dirty_frames) == 0) return;
+        for (size_t i = 0; i < list_length(dirty_frames); i++) {
+            UIFrame* f = list_get(dirty_frames, i);
+            f->layout_dirty = 0;
+            sx_update_layout(f);
+        }
+        list_free(dirty_frames);
+        dirty_frames = NULL;
+        if (!constraints_dirty) return;
+    }
+}
 
-    UIElement** sorted = malloc(count * sizeof(UIElement*));
-    if (!sorted) return NULL;
+// --- Text sizing ---
 
-    for (int i = 0; i < count; i++) {
-        sorted[i] = list_get(l, i);
+static const char* _element_text(UIElement* el) {
+    switch (el->type) {
+        case UI_BUTTON: return ((UIButton*)el)->text;
+        case UI_LABEL: return ((UILabel*)el)->text;
+        case UI_CHECKBOX: return ((UICheckBox*)el)->text;
+        default: return NULL;
     }
-    
-    qsort(sorted, count, sizeof(UIElement*), compare_elements_desc);
-    
-    UIElement* result = NULL;
+}
 
-    for (int i = 0; i < count; i++) {
-        UIElement* e = sorted[i];
-        if (e->flags & UI_FLAG_HIDDEN) continue;
-        
-        int wx = px + e->x;
-        int wy = py + e->y;
-        
-        int hit_h = e->h;
-        
-        if (e->type == UI_DROPDOWN) {
-            UIDropdown* dd = (UIDropdown*)e;
-            if (dd->is_open) {
-                hit_h = 30 + (dd->option_count * 30);
-            }
-        }
+#define TEXT_PAD_X 10
+#define TEXT_PAD_Y 6
 
-        if (mx >= wx && mx <= wx + e->w && my >= wy && my <= wy + hit_h) {
-            int scroll = (e->type == UI_FRAME) ? ((UIFrame*)e)->scroll_y : 0;
-            
-            UIElement* child = _get_hit(e->children, mx, my, wx, wy - scroll);
-            
-            result = child ? child : e;
-            break; 
-        }
+// Only widgets that asked for auto-sizing or custom padding carry one;
+// flex layouts measure every other text widget with the default padding.
+static UITextSize* _text_size_get(UIElement* el) {
+    if (!el->text_size) {
+        el->text_size = calloc(1, sizeof(UITextSize));
+        if (!el->text_size) return NULL;
+        el->text_size->pad_x = TEXT_PAD_X;
+        el->text_size->pad_y = TEXT_PAD_Y;
     }
+    return el->text_size;
+}
 
-    free(sorted);
-    return result;
+static void _text_size_free(UIElement* el) {
+    free(el->text_size);
+    el->text_size = NULL;
 }
 
-void init_base(UIElement* el, int x, int y, int w, int h, UIType t) {
-    el->x = x;
-    el->y = y;
-    el->w = w;
-    el->h = h;
-    el->type = t;
-    el->flags = UI_FLAG_NONE;
-    el->parent = NULL;
-    el->children = list_new();
-    el->_is_hovered = 0;
-    el->_is_hovered_prev = 0;
-    el->_is_dragging = 0;
-    el->z_index = 0;
-    el->creation_time = SDL_GetTicks();
-    el->transparency = 1.0f;
-    el->custom_color = SX_COLOR_NONE;
-    el->has_custom_color = 0;
-    el->onMouseEnter = list_new();
-    el->onMouseLeave = list_new();
-    
-    el->effects.gradient.enabled = 0;
-    el->effects.gradient.stops = NULL;
-    el->effects.gradient.angle = 90.0f;
-    el->effects.outline.enabled = 0;
-    el->effects.outline.width = 1;
-    el->effects.outline.color = SX_COLOR_BLACK;
-    el->effects.outline.alpha = 255;
-    el->effects.rounded.enabled = 0;
-    el->effects.rounded.radius = 0;
+// Checkboxes draw a square box as tall as the widget plus a 10px gap
+// before the text.
+static void _text_measure(UIElement* el, int pad_x, int pad_y, int* w, int* h) {
+    TTF_Font* font = _get_active_font();
+    int tw = _measure_text(_element_text(el));
+    *h = (font ? TTF_FontHeight(font) : 0) + 2 * pad_y;
+    *w = el->type == UI_CHECKBOX ? *h + 10 + tw + pad_x : tw + 2 * pad_x;
 }
 
-void _add_to_parent(UIElement* p, UIElement* c) {
-    if (p) {
-        c->parent = p;
-        list_add(p->children, c);
-        if (p->type == UI_FRAME) sx_update_layout((UIFrame*)p);
-    } else {
-        list_add(engine.root, c);
+// Without a UITextSize the measurement is cached on the flex item, which
+// every widget a flex layout measures already has.
+static void _text_intrinsic(UIElement* el, int* w, int* h) {
+    UITextSize* t = el->text_size;
+    if (!t && !el->flex) {
+        _text_measure(el, TEXT_PAD_X, TEXT_PAD_Y, w, h);
+        return;
     }
+    if (!t) {
+        if (el->flex->text_w <= 0) _text_measure(el, TEXT_PAD_X, TEXT_PAD_Y, &el->flex->text_w, &el->flex->text_h);
+        *w = el->flex->text_w;
+        *h = el->flex->text_h;
+        return;
+    }
+    if (!t->valid) {
+        _text_measure(el, t->pad_x, t->pad_y, &t->w, &t->h);
+        t->valid = 1;
+    }
+    *w = t->w;
+    *h = t->h;
+}
+
+// The intrinsic size is also the widget's preferred flex size; flex
+// layouts would otherwise keep resizing it back to its first measurement.
+static void _text_size_apply(UIElement* el) {
+    int w, h;
+    _text_intrinsic(el, &w, &h);
+    if (el->flex) {
+        el->flex->pref_w = w;
+        el->flex->pref_h = h;
+    }
+    if (w == el->w && h == el->h) return;
+    el->w = w;
+    el->h = h;
+    _layout_invalidate_child(el);
 }
 
-<<<<<<< HEAD
-void sxui_init(const char* title, int w, int h, Uint32 seed) {
-    SDL_Init(SDL_INIT_VIDEO);
-    TTF_Init();
-    
-    engine.window = SDL_CreateWindow(title, SDL_WINDOWPOS_CENTERED, 
-                                     SDL_WINDOWPOS_CENTERED, w, h, SDL_WINDOW_SHOWN);
-    engine.renderer = SDL_CreateRenderer(engine.window, -1, 
-                                        SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
-    SDL_EventState(SDL_DROPFILE, SDL_ENABLE);
+// Called when the text or padding changed. Flex parents re-measure the
+// widget even when it is not auto-sized.
+static void _text_size_changed(UIElement* el) {
+    if (el->flex) el->flex->text_w = 0;
+    if (el->text_size) el->text_size->valid = 0;
+    if (el->text_size && el->text_size->enabled) _text_size_apply(el);
+    else if (el->flex) _layout_invalidate_child(el);
+}
 
-    engine.default_font = TTF_OpenFont("fonts/Montserrat-Regular.ttf", 16);
-    if (!engine.default_font) {
-        printf("Warning: Could not load fallback font Montserrat.\n");
+static void _text_size_refresh(list* elements) {
+    if (!elements) return;
+    for (size_t i = 0; i < list_length(elements); i++) {
+        UIElement* el = list_get(elements, i);
+        if (_element_text(el)) _text_size_changed(el);
+        _text_size_refresh(el->children);
     }
-    engine.custom_font = NULL;
-    
-    engine.root = list_new();
-    engine.theme = sx_generate_palette(seed, THEME_DARK);
-    engine.running = 1;
-    engine.focused = NULL;
-    engine.dragging_el = NULL;
-    engine.page_manager.pages = NULL;
-    engine.page_manager.current_page = -1;
-    engine.page_manager.initialized = 0;
-    engine.file_drop_callback = NULL;
 }
 
-int sxui_load_font(const char* path, int size) {
-    if (engine.custom_font) {
-        TTF_CloseFont(engine.custom_font);
-    }
-    engine.custom_font = TTF_OpenFont(path, size);
-    return (engine.custom_font != NULL);
-=======
-void init_base(UIElement *el, int x, int y, int w, int h, UIType t) {
-  el->x = x;
-  el->y = y;
-  el->w = w;
-  el->h = h;
-  el->type = t;
-  engine.last_created = el;
-  el->flags = UI_FLAG_NONE;
-  el->parent = NULL;
-  el->children = list_new();
-  el->_is_hovered = 0;
-  el->_is_hovered_prev = 0;
-  el->_is_dragging = 0;
-  el->z_index = 0;
-  el->creation_time = SDL_GetTicks();
-  el->transparency = 1.0f;
-  el->custom_color = SX_COLOR_NONE;
-  el->has_custom_color = 0;
-  el->onMouseEnter = list_new();
-  el->onMouseLeave = list_new();
-  el->onMouseClick = list_new();
+// Font changes are rare, so they walk the tree rather than every text
+// widget paying for a registry entry on create and delete.
+static void _text_size_font_changed(void) {
+    _text_size_refresh(engine.root);
+}
 
-  el->effects.gradient.enabled = 0;
-  el->effects.gradient.stops = NULL;
-  el->effects.gradient.angle = 90.0f;
-  el->effects.outline.enabled = 0;
-  el->effects.outline.width = 1;
-  el->effects.outline.color = SX_COLOR_BLACK;
-  el->effects.outline.alpha = 255;
-  el->effects.rounded.enabled = 0;
-  el->effects.rounded.radius = 0;
-  engine.last_created = el;
+// --- Flex layout ---
+
+typedef struct {
+    UIElement* el;
+    float base, size;
+    int cross;
+    int frozen;
+} FlexSlot;
+
+static FlexSlot* flex_slots = NULL;
+static int flex_slot_cap = 0;
+
+static UIFlexItem* _flex_item(UIElement* el) {
+    if (!el->flex) {
+        el->flex = calloc(1, sizeof(UIFlexItem));
+        if (!el->flex) return NULL;
+        el->flex->shrink = 1;
+        el->flex->basis = UI_FLEX_BASIS_AUTO;
+        el->flex->pref_w = el->w;
+        el->flex->pref_h = el->h;
+    }
+    return el->flex;
 }
 
-void _add_to_parent(UIElement *p, UIElement *c) {
-  if (p) {
-    c->parent = p;
-    list_add(p->children, c);
-    if (p->type == UI_FRAME)
-      sx_update_layout((UIFrame *)p);
-  } else {
-    list_add(engine.root, c);
-  }
+static void _flex_free(UIElement* el) {
+    free(el->flex);
+    el->flex = NULL;
 }
 
-void sxui_init(const char *title, int w, int h, Uint32 seed) {
-  SDL_Init(SDL_INIT_VIDEO);
-  TTF_Init();
+static int _flex_clamp(int v, int lo, int hi) {
+    if (hi > 0 && v > hi) v = hi;
+    if (v < lo) v = lo;
+    return v;
+}
 
-  engine.window =
-      SDL_CreateWindow(title, SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
-                       w, h, SDL_WINDOW_SHOWN | SDL_WINDOW_ALLOW_HIGHDPI);
-  engine.window_width = w;
-  engine.window_height = h;
+static void _flex_measure(UIElement* el, int avail_w, int avail_h, int* out_w, int* out_h);
 
-  if (engine.window == NULL) {
-    // Handle error, e.g., print to stderr and exit
-  }
-  engine.renderer = SDL_CreateRenderer(
-      engine.window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
-  SDL_EventState(SDL_DROPFILE, SDL_ENABLE);
+// Main axis: the children's bases plus spacing. Cross axis: the largest child.
+static void _flex_content_size(UIFrame* f, int avail_w, int avail_h, int* out_w, int* out_h) {
+    int row = (f->el.flags & UI_LAYOUT_HORIZONTAL) != 0;
+    int inner_w = avail_w - 2 * f->padding, inner_h = avail_h - 2 * f->padding;
+    if (inner_w < 0) inner_w = 0;
+    if (inner_h < 0) inner_h = 0;
 
-  engine.default_font = TTF_OpenFont("fonts/Montserrat-Regular.ttf", 16);
-  if (!engine.default_font) {
-    printf("Warning: Could not load fallback font Montserrat.\n");
-  }
-  engine.custom_font = NULL;
+    int main_size = 0, cross = 0, n = 0;
+    for (size_t i = 0; i < list_length(f->el.children); i++) {
+        UIElement* c = list_get(f->el.children, i);
+        if (!_is_laid_out(c)) continue;
+        int cw, ch;
+        _flex_measure(c, inner_w, inner_h, &cw, &ch);
+        if (!c->flex) continue;
+        main_size += c->flex->basis >= 0 ? c->flex->basis : (row ? cw : ch);
+        if ((row ? ch : cw) > cross) cross = row ? ch : cw;
+        n++;
+    }
+    if (n > 1) main_size += (n - 1) * f->spacing;
+    *out_w = (row ? main_size : cross) + 2 * f->padding;
+    *out_h = (row ? cross : main_size) + 2 * f->padding;
+}
+
+// Sizes that were never set explicitly are measured: flex frames from their
+// content, text widgets from their intrinsic size, anything else from the
+// parent's default child size like the flow layouts. The result is kept until the
+// node is invalidated and reused for as long as the available space it was
+// computed under stays the same, so relaying out a container only measures
+// the children that actually changed.
+static void _flex_measure(UIElement* el, int avail_w, int avail_h, int* out_w, int* out_h) {
+    UIFlexItem* it = _flex_item(el);
+    if (!it) {
+        *out_w = el->w;
+        *out_h = el->h;
+        return;
+    }
+    for (int i = 0; i < it->cached; i++) {
+        if (it->cache[i].avail_w == avail_w && it->cache[i].avail_h == avail_h) {
+            *out_w = it->cache[i].w;
+            *out_h = it->cache[i].h;
+            return;
+        }
+    }
 
-  engine.root = list_new();
-  engine.theme = sx_generate_palette(seed, THEME_DARK);
-  engine.running = 1;
-  engine.focused = NULL;
-  engine.dragging_el = NULL;
-  engine.page_manager.pages = NULL;
-  engine.page_manager.current_page = -1;
-  engine.page_manager.initialized = 0;
-  engine.file_drop_callback = NULL;
+    int w = it->pref_w, h = it->pref_h;
+    if (w <= 0 || h <= 0) {
+        if (_is_flex_frame(el)) {
+            int cw, ch;
+            _flex_content_size((UIFrame*)el, w > 0 ? w : avail_w, h > 0 ? h : avail_h, &cw, &ch);
+            if (w <= 0) w = cw;
+            if (h <= 0) h = ch;
+        } else if (_element_text(el)) {
+            int tw, th;
+            _text_intrinsic(el, &tw, &th);
+            if (w <= 0) w = tw;
+            if (h <= 0) h = th;
+        } else {
+            UIElement* p = el->parent;
+            if (w <= 0) w = (p && p->target_w > 0) ? p->target_w : 100;
+            if (h <= 0) h = (p && p->target_h > 0) ? p->target_h : 30;
+        }
+    }
+    w = _flex_clamp(w, it->min_w, it->max_w);
+    h = _flex_clamp(h, it->min_h, it->max_h);
+
+    int slot;
+    if (it->cached < FLEX_CACHE_SLOTS) slot = it->cached++;
+    else slot = it->cache_next = (it->cache_next + 1) % FLEX_CACHE_SLOTS;
+    it->cache[slot].avail_w = avail_w;
+    it->cache[slot].avail_h = avail_h;
+    it->cache[slot].w = w;
+    it->cache[slot].h = h;
+    *out_w = w;
+    *out_h = h;
+}
+
+// Positive free space is shared by grow factors, negative by shrink factors
+// weighted by basis. An item its min/max clamps is frozen at that size and
+// the rest is redistributed among the others.
+static void _flex_resolve(FlexSlot* slots, int count, float space, int row) {
+    float used = 0;
+    for (int i = 0; i < count; i++) used += slots[i].base;
+    int growing = space > used;
+    if (space == used) return;
+
+    for (int pass = 0; pass < count; pass++) {
+        float free_space = space, weight = 0;
+        for (int i = 0; i < count; i++) {
+            FlexSlot* s = &slots[i];
+            UIFlexItem* it = s->el->flex;
+            if (s->frozen) {
+                free_space -= s->size;
+            } else {
+                free_space -= s->base;
+                weight += growing ? it->grow : it->shrink * s->base;
+            }
+        }
+        if (weight <= 0) return;
+
+        int clamped = 0;
+        for (int i = 0; i < count; i++) {
+            FlexSlot* s = &slots[i];
+            if (s->frozen) continue;
+            UIFlexItem* it = s->el->flex;
+            float share = growing ? it->grow : it->shrink * s->base;
+            float size = s->base + free_space * share / weight;
+            int lo = row ? it->min_w : it->min_h, hi = row ? it->max_w : it->max_h;
+            if (size < lo) {
+                size = lo;
+                s->frozen = clamped = 1;
+            } else if (hi > 0 && size > hi) {
+                size = hi;
+                s->frozen = clamped = 1;
+            }
+            s->size = size;
+        }
+        if (!clamped) return;
+    }
 }
 
-int sxui_load_font(const char *path, int size) {
-  if (engine.custom_font) {
-    TTF_CloseFont(engine.custom_font);
-  }
-  engine.custom_font = TTF_OpenFont(path, size);
-  return (engine.custom_font != NULL);
->>>>>>> 410878f (feat: Add new pages and enhance input handling)
-}
+static void _flex_layout(UIFrame* f) {
+    int row = (f->el.flags & UI_LAYOUT_HORIZONTAL) != 0;
+    int pad = f->padding;
+    int inner_w = f->el.w - 2 * pad, inner_h = f->el.h - 2 * pad;
+    if (inner_w < 0) inner_w = 0;
+    if (inner_h < 0) inner_h = 0;
+    int inner_main = row ? inner_w : inner_h, inner_cross = row ? inner_h : inner_w;
+
+    int n = list_length(f->el.children);
+    if (n > flex_slot_cap) {
+        FlexSlot* slots = realloc(flex_slots, n * sizeof(FlexSlot));
+        if (!slots) return;
+        flex_slots = slots;
+        flex_slot_cap = n;
+    }
 
-void sxui_set_theme(Uint32 seed, UIThemeMode mode) {
-    engine.theme = sx_generate_palette(seed, mode);
-}
+    layout_running++;
+    int count = 0;
+    for (int i = 0; i < n; i++) {
+        UIElement* c = list_get(f->el.children, i);
+        if (!_is_laid_out(c)) continue;
+        int cw, ch;
+        _flex_measure(c, inner_w, inner_h, &cw, &ch);
+        UIFlexItem* it = c->flex;
+        if (!it) continue;
+        FlexSlot* s = &flex_slots[count++];
+        s->el = c;
+        s->base = it->basis >= 0 ? it->basis : (row ? cw : ch);
+        s->base = _flex_clamp((int)s->base, row ? it->min_w : it->min_h, row ? it->max_w : it->max_h);
+        s->size = s->base;
+        s->cross = row ? ch : cw;
+        s->frozen = 0;
+    }
 
-void _delete_element_recursive(UIElement* el);
+    float gaps = count > 1 ? (float)(count - 1) * f->spacing : 0;
+    _flex_resolve(flex_slots, count, inner_main - gaps, row);
+
+    float total = gaps;
+    for (int i = 0; i < count; i++) total += flex_slots[i].size;
+    float leftover = inner_main - total, lead = 0, between = 0;
+    if (leftover < 0) leftover = 0;
+    switch (f->justify) {
+        case UI_FLEX_JUSTIFY_CENTER: lead = leftover / 2; break;
+        case UI_FLEX_JUSTIFY_END: lead = leftover; break;
+        case UI_FLEX_JUSTIFY_SPACE_BETWEEN: between = count > 1 ? leftover / (count - 1) : 0; break;
+        case UI_FLEX_JUSTIFY_SPACE_AROUND: between = count ? leftover / count : 0; lead = between / 2; break;
+        case UI_FLEX_JUSTIFY_SPACE_EVENLY: between = leftover / (count + 1); lead = between; break;
+        default: break;
+    }
 
-void sxui_cleanup(void) {
-    if (engine.root) {
-        for (size_t i = 0; i < list_length(engine.root); i++) {
-            UIElement* el = list_get(engine.root, i);
-            _delete_element_recursive(el);
+    // Edges are rounded rather than sizes so adjacent items never leave a
+    // one-pixel gap between them.
+    float pos = pad + lead;
+    int bottom = 0, right = 0;
+    for (int i = 0; i < count; i++) {
+        FlexSlot* s = &flex_slots[i];
+        UIElement* c = s->el;
+        UIFlexItem* it = c->flex;
+        int start = (int)lroundf(pos), end = (int)lroundf(pos + s->size);
+        pos += s->size + f->spacing + between;
+
+        UIFlexAlign align = it->align_self != UI_FLEX_ALIGN_AUTO ? it->align_self : f->align;
+        int cross = s->cross;
+        if ((align == UI_FLEX_ALIGN_AUTO || align == UI_FLEX_ALIGN_STRETCH) && (row ? it->pref_h : it->pref_w) <= 0)
+            cross = _flex_clamp(inner_cross, row ? it->min_h : it->min_w, row ? it->max_h : it->max_w);
+        int cross_pos = pad;
+        if (align == UI_FLEX_ALIGN_CENTER) cross_pos += (inner_cross - cross) / 2;
+        else if (align == UI_FLEX_ALIGN_END) cross_pos += inner_cross - cross;
+
+        c->x = row ? start : cross_pos;
+        c->y = row ? cross_pos : start;
+        int w = row ? end - start : cross, h = row ? cross : end - start;
+        if (w != c->w || h != c->h) {
+            sxui_set_size(c, w, h);
+            if (c->type == UI_FRAME) ((UIFrame*)c)->layout_from = 0;
         }
-        list_free(engine.root);
+        if (c->y + c->h > bottom) bottom = c->y + c->h;
+        if (c->x + c->w > right) right = c->x + c->w;
     }
-    
-    if (engine.page_manager.pages) {
-        list_free(engine.page_manager.pages);
+    f->content_height = bottom + pad;
+    f->content_width = right + pad;
+
+    // Only child frames that were resized or have pending changes of their
+    // own are laid out again; the rest of the tree is left alone.
+    for (int i = 0; i < n; i++) {
+        UIElement* c = list_get(f->el.children, i);
+        if (c->type == UI_FRAME && !(c->flags & UI_FLAG_HIDDEN) && ((UIFrame*)c)->layout_from != INT_MAX)
+            sx_update_layout((UIFrame*)c);
     }
-    
-    if (engine.default_font) {
-        TTF_CloseFont(engine.default_font);
-        engine.default_font = NULL;
+    layout_running--;
+}
+
+// --- Constraints ---
+
+typedef struct {
+    UIElement* el;
+    int depth;
+} ConstraintSlot;
+
+static ConstraintSlot* constraint_slots = NULL;
+static int constraint_slot_cap = 0;
+static SDL_threadID main_thread_id = 0;
+static int in_render = 0;
+static int in_poll = 0;
+static Uint32 poll_started = 0;
+
+static void _constraint_parent_size(UIElement* el, int* w, int* h) {
+    if (el->parent) {
+        *w = el->parent->w;
+        *h = el->parent->h;
+    } else {
+        SDL_GetWindowSize(engine.window, w, h);
     }
-    if (engine.custom_font) {
-        TTF_CloseFont(engine.custom_font);
-        engine.custom_font = NULL;
+}
+
+static UIConstraint* _constraint_get(UIElement* el) {
+    if (!el->constraint) {
+        el->constraint = calloc(1, sizeof(UIConstraint));
+        if (!el->constraint) return NULL;
+        if (!constrained) constrained = list_new();
+        list_add(constrained, el);
+    }
+    return el->constraint;
+}
+
+static void _constraint_free(UIElement* el) {
+    if (!el->constraint) return;
+    list_remove(constrained, el);
+    free(el->constraint);
+    el->constraint = NULL;
+}
+
+static void _constraint_axis(int anchors, int lo, int hi, int center, int m_lo, int m_hi,
+                             int size, int* pos, int* len) {
+    if ((anchors & lo) && (anchors & hi)) {
+        *pos = m_lo;
+        *len = size - m_lo - m_hi;
+    } else if (anchors & hi) {
+        *pos = size - m_hi - *len;
+    } else if (anchors & center) {
+        *pos = (size - *len) / 2 + m_lo;
+    } else if (anchors & lo) {
+        *pos = m_lo;
     }
-    SDL_DestroyRenderer(engine.renderer);
-    SDL_DestroyWindow(engine.window);
-    TTF_Quit();
-    SDL_Quit();
 }
 
-int sxui_should_quit(void) {
-    return !engine.running;
+// Elements whose parent has not changed size since they were last fitted
+// are skipped, so a pass only touches what the resize actually affects.
+static void _constraint_fit(UIElement* el) {
+    UIConstraint* k = el->constraint;
+    int pw, ph;
+    _constraint_parent_size(el, &pw, &ph);
+    if (pw == k->parent_w && ph == k->parent_h) return;
+    k->parent_w = pw;
+    k->parent_h = ph;
+
+    int x = el->x, y = el->y, w = el->w, h = el->h;
+    if (k->pct_w > 0) w = (int)lroundf(pw * k->pct_w / 100.0f);
+    if (k->pct_h > 0) h = (int)lroundf(ph * k->pct_h / 100.0f);
+    _constraint_axis(k->anchors, UI_ANCHOR_LEFT, UI_ANCHOR_RIGHT, UI_ANCHOR_CENTER_X,
+                     k->left, k->right, pw, &x, &w);
+    _constraint_axis(k->anchors, UI_ANCHOR_TOP, UI_ANCHOR_BOTTOM, UI_ANCHOR_CENTER_Y,
+                     k->top, k->bottom, ph, &y, &h);
+    if (w < 0) w = 0;
+    if (h < 0) h = 0;
+
+    el->x = x;
+    el->y = y;
+    _hit_invalidate(el->parent);
+    if (w != el->w || h != el->h) sxui_set_size(el, w, h);
 }
 
-void sxui_poll_events(void) {
-<<<<<<< HEAD
-    SDL_Event e;
-    int mx, my;
-    SDL_GetMouseState(&mx, &my);
+static int _constraint_cmp(const void* a, const void* b) {
+    return ((const ConstraintSlot*)a)->depth - ((const ConstraintSlot*)b)->depth;
+}
 
-    while (SDL_PollEvent(&e)) {
-        if (e.type == SDL_QUIT) {
-            engine.running = 0;
+// One top-down pass over the constrained elements only: parents are fitted
+// before their children, so every element sees its parent's final size.
+static void _constraints_apply(void) {
+    int n = constrained ? list_length(constrained) : 0;
+    if (n > constraint_slot_cap) {
+        ConstraintSlot* slots = realloc(constraint_slots, n * sizeof(ConstraintSlot));
+        if (!slots) return;
+        constraint_slots = slots;
+        constraint_slot_cap = n;
+    }
+    for (int i = 0; i < n; i++) {
+        UIElement* el = list_get(constrained, i);
+        int depth = 0;
+        for (UIElement* p = el->parent; p; p = p->parent) depth++;
+        constraint_slots[i].el = el;
+        constraint_slots[i].depth = depth;
+    }
+    qsort(constraint_slots, n, sizeof(ConstraintSlot), _constraint_cmp);
+    for (int i = 0; i < n; i++) _constraint_fit(constraint_slots[i].el);
+    constraints_dirty = 0;
+}
+
+// SDL calls the watch as events are queued. During a live resize some
+// platforms run a modal loop that stalls the main loop inside
+// SDL_PollEvent, so once a poll has been blocked for RESIZE_STALL_MS the
+// constraints are applied and a frame is drawn from here to keep the window
+// contents following the drag. Ordinary resizes are left to the app's loop.
+#define RESIZE_STALL_MS 10
+
+static int _resize_watch(void* userdata, SDL_Event* e) {
+    (void)userdata;
+    if (e->type != SDL_WINDOWEVENT || e->window.event != SDL_WINDOWEVENT_SIZE_CHANGED) return 0;
+    if (SDL_ThreadID() != main_thread_id) return 0;
+    constraints_dirty = 1;
+    if (!in_render && in_poll && SDL_GetTicks() - poll_started >= RESIZE_STALL_MS) sxui_render();
+    return 0;
+}
+
+void sxui_set_resizable(int resizable) {
+    SDL_SetWindowResizable(engine.window, resizable ? SDL_TRUE : SDL_FALSE);
+}
+
+// --- Posting ---
+// Other threads hand work to the UI thread through a bounded MPSC ring.
+// Producers claim a cell by CAS on post_head and publish it by advancing the
+// cell's sequence, so posting never takes a lock; only the UI thread reads.
+// The ring is drained at the start of sxui_poll_events and again once the
+// input batch has been dispatched, never in between, so posted callbacks
+// cannot free elements that queued input events still point at. The second
+// drain also catches posts whose wake event the poll loop swallowed.
+// Repeated text or value posts to the same element collapse into the newest
+// one.
+#define POST_RING_SIZE 1024
+
+typedef enum { POST_CALL, POST_SET_TEXT, POST_SET_VALUE } PostKind;
+
+typedef struct {
+    SDL_atomic_t sequence;
+    PostKind kind;
+    PostCallback fn;
+    void* target;
+    char* text;
+    float value;
+} PostCell;
+
+static PostCell post_ring[POST_RING_SIZE];
+static PostCell post_batch[POST_RING_SIZE];
+static SDL_atomic_t post_head;
+static Uint32 post_tail = 0;
+static SDL_atomic_t post_wake;
+static Uint32 post_event = (Uint32)-1;
+
+static struct {
+    void* target;
+    PostKind kind;
+    Uint32 stamp;
+} post_seen[POST_RING_SIZE * 2];
+static Uint32 post_stamp = 0;
+
+static void _posts_init(void) {
+    for (int i = 0; i < POST_RING_SIZE; i++) SDL_AtomicSet(&post_ring[i].sequence, i);
+    SDL_AtomicSet(&post_head, 0);
+    SDL_AtomicSet(&post_wake, 0);
+    post_tail = 0;
+    post_event = SDL_RegisterEvents(1);
+}
+
+static int _post(PostKind kind, PostCallback fn, void* target, char* text, float value) {
+    PostCell* cell;
+    Uint32 pos = (Uint32)SDL_AtomicGet(&post_head);
+    for (;;) {
+        cell = &post_ring[pos & (POST_RING_SIZE - 1)];
+        int diff = (int)((Uint32)SDL_AtomicGet(&cell->sequence) - pos);
+        if (diff == 0) {
+            if (SDL_AtomicCAS(&post_head, (int)pos, (int)(pos + 1))) break;
+        } else if (diff < 0) {
+            return 0;   // full: the UI thread is POST_RING_SIZE posts behind
         }
-        
-        if (e.type == SDL_DROPFILE) {
-            char* dropped_file = e.drop.file;
-            UIElement* hit = _get_hit(engine.root, mx, my, 0, 0);
-            
-            if (engine.file_drop_callback) {
-                engine.file_drop_callback(hit, dropped_file);
-=======
-  SDL_Event e;
-  int mx, my;
-  SDL_GetMouseState(&mx, &my);
-  engine.mouse_x = mx;
-  engine.mouse_y = my;
+        pos = (Uint32)SDL_AtomicGet(&post_head);
+    }
+    cell->kind = kind;
+    cell->fn = fn;
+    cell->target = target;
+    cell->text = text;
+    cell->value = value;
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&cell->sequence, (int)(pos + 1));
+
+    // One wake event per drain is enough to get the UI thread out of
+    // SDL_WaitEvent; the flag keeps a busy producer from flooding SDL's queue.
+    if (post_event != (Uint32)-1 && SDL_AtomicCAS(&post_wake, 0, 1)) {
+        SDL_Event e;
+        memset(&e, 0, sizeof(e));
+        e.type = post_event;
+        SDL_PushEvent(&e);
+    }
+    return 1;
+}
 
-  // Sync previous states
-  memcpy(engine.last_mouse_buttons, engine.mouse_buttons,
-         sizeof(engine.mouse_buttons));
-  memcpy(engine.last_keyboard_state, engine.keyboard_state,
-         sizeof(engine.keyboard_state));
+int sxui_post(PostCallback fn, void* userdata) {
+    if (!fn) return 0;
+    return _post(POST_CALL, fn, userdata, NULL, 0);
+}
 
-  while (SDL_PollEvent(&e)) {
-    if (e.type == SDL_QUIT) {
-      engine.running = 0;
+int sxui_post_set_text(UIElement* el, const char* text) {
+    if (!el) return 0;
+    char* copy = strdup(text ? text : "");
+    if (!copy) return 0;
+    if (!_post(POST_SET_TEXT, NULL, el, copy, 0)) {
+        free(copy);
+        return 0;
     }
+    return 1;
+}
 
-    if (e.type == SDL_WINDOWEVENT) {
-      if (e.window.event == SDL_WINDOWEVENT_RESIZED) {
-        engine.window_width = e.window.data1;
-        engine.window_height = e.window.data2;
-      }
+int sxui_post_set_value(UIElement* el, float value) {
+    if (!el) return 0;
+    return _post(POST_SET_VALUE, NULL, el, NULL, value);
+}
+
+static void _post_seen_reset(void) {
+    if (++post_stamp == 0) {
+        memset(post_seen, 0, sizeof(post_seen));
+        post_stamp = 1;
     }
+}
 
-    if (e.type == SDL_KEYDOWN) {
-      if (e.key.keysym.scancode < 512) {
-        engine.keyboard_state[e.key.keysym.scancode] = 1;
-      }
+// Marks (target, kind) as seen since the last reset; returns 1 if it already was.
+static int _post_seen(void* target, PostKind kind) {
+    Uint32 h = (Uint32)(((uintptr_t)target >> 4) * 2654435761u) ^ (Uint32)kind;
+    for (;;) {
+        h &= POST_RING_SIZE * 2 - 1;
+        if (post_seen[h].stamp != post_stamp) {
+            post_seen[h].target = target;
+            post_seen[h].kind = kind;
+            post_seen[h].stamp = post_stamp;
+            return 0;
+        }
+        if (post_seen[h].target == target && post_seen[h].kind == kind) return 1;
+        h++;
     }
-    if (e.type == SDL_KEYUP) {
-      if (e.key.keysym.scancode < 512) {
-        engine.keyboard_state[e.key.keysym.scancode] = 0;
-      }
+}
+
+static void _posts_drain(void) {
+    SDL_AtomicSet(&post_wake, 0);
+    int count = 0;
+    while (count < POST_RING_SIZE) {
+        PostCell* cell = &post_ring[post_tail & (POST_RING_SIZE - 1)];
+        if ((Uint32)SDL_AtomicGet(&cell->sequence) != post_tail + 1) break;
+        SDL_MemoryBarrierAcquire();
+        post_batch[count++] = *cell;
+        SDL_MemoryBarrierRelease();
+        SDL_AtomicSet(&cell->sequence, (int)(post_tail + POST_RING_SIZE));
+        post_tail++;
+    }
+    if (!count) return;
+
+    // Walk backwards so the newest update of each element property wins.
+    // Generic calls may read the state being updated, so updates are only
+    // merged across a run that no sxui_post call sits in.
+    _post_seen_reset();
+    for (int i = count - 1; i >= 0; i--) {
+        PostCell* p = &post_batch[i];
+        if (p->kind == POST_CALL) {
+            _post_seen_reset();
+        } else if (_post_seen(p->target, p->kind)) {
+            free(p->text);
+            p->kind = POST_CALL;
+            p->fn = NULL;
+        }
     }
+    for (int i = 0; i < count; i++) {
+        PostCell* p = &post_batch[i];
+        switch (p->kind) {
+            case POST_CALL:
+                if (p->fn) p->fn(p->target);
+                break;
+            case POST_SET_TEXT:
+                sxui_set_text(p->target, p->text);
+                free(p->text);
+                break;
+            case POST_SET_VALUE:
+                sxui_set_value(p->target, p->value);
+                break;
+        }
+    }
+}
 
-    if (e.type == SDL_DROPFILE) {
-      char *dropped_file = e.drop.file;
-      UIElement *hit = _get_hit(engine.root, mx, my, 0, 0);
+// --- Clock ---
+// Timed effects (press flash, cursor blink, scrollbar fade, kinetic
+// scrolling, creation_time) read time through these instead of SDL, so a
+// replayed session sees the clock it was recorded with.
+static int clock_virtual = 0;
+static Uint32 clock_ticks = 0;
+static Uint32 clock_origin = 0;
+static Uint64 clock_origin_counter = 0;
+// A replay usually runs ahead of real time; these keep the clock from
+// stepping backwards once it ends.
+static Uint32 clock_offset = 0;
+static Uint64 clock_counter_offset = 0;
 
-      if (engine.file_drop_callback) {
-        engine.file_drop_callback(hit, dropped_file);
-      }
+static Uint32 _clock_ticks(void) {
+    return clock_virtual ? clock_ticks : SDL_GetTicks() + clock_offset;
+}
 
-      SDL_free(dropped_file);
+Uint32 sxui_get_ticks(void) {
+    return _clock_ticks();
+}
+
+static Uint64 _clock_counter(void) {
+    if (!clock_virtual) return SDL_GetPerformanceCounter() + clock_counter_offset;
+    return clock_origin_counter + (Uint64)(clock_ticks - clock_origin) * SDL_GetPerformanceFrequency() / 1000;
+}
+
+// --- Latency ---
+// Every input event consumed by sxui_poll_events leaves a pending sample
+// holding its SDL timestamp; the sample is closed by the next
+// SDL_RenderPresent and binned per event kind, so the histograms measure
+// input-to-pixels latency including hit testing and callback dispatch.
+#define LATENCY_PENDING_MAX 1024
+
+static const Uint32 latency_limits[UI_LATENCY_BUCKETS] = {
+    1, 2, 4, 6, 8, 12, 16, 24, 32, 48, 64, 96, 128, 256, 512, 0xFFFFFFFF
+};
+
+typedef struct {
+    Uint32 count;
+    Uint64 total_ms;
+    Uint32 max_ms;
+    Uint32 buckets[UI_LATENCY_BUCKETS];
+} LatencyHistogram;
+
+static LatencyHistogram latency_hist[UI_LATENCY_KINDS];
+static struct {
+    UILatencyKind kind;
+    Uint32 stamp;
+} latency_pending[LATENCY_PENDING_MAX];
+static int latency_pending_count = 0;
+static int latency_low = 0;
+static int latency_overlay = 0;
+
+static void _latency_note(const SDL_Event* e, Uint32 stamp) {
+    UILatencyKind kind;
+    switch (e->type) {
+        case SDL_MOUSEMOTION: kind = UI_LATENCY_MOTION; break;
+        case SDL_MOUSEBUTTONDOWN:
+        case SDL_MOUSEBUTTONUP: kind = UI_LATENCY_BUTTON; break;
+        case SDL_MOUSEWHEEL: kind = UI_LATENCY_WHEEL; break;
+        case SDL_KEYDOWN:
+        case SDL_KEYUP: kind = UI_LATENCY_KEY; break;
+        case SDL_TEXTINPUT: kind = UI_LATENCY_TEXT; break;
+        default: return;
+    }
+    if (latency_pending_count == LATENCY_PENDING_MAX) return;
+    latency_pending[latency_pending_count].kind = kind;
+    latency_pending[latency_pending_count].stamp = stamp;
+    latency_pending_count++;
+}
+
+static void _latency_presented(void) {
+    Uint32 now = SDL_GetTicks();
+    for (int i = 0; i < latency_pending_count; i++) {
+        Sint32 d = (Sint32)(now - latency_pending[i].stamp);
+        Uint32 ms = d > 0 ? (Uint32)d : 0;
+        LatencyHistogram* h = &latency_hist[latency_pending[i].kind];
+        int b = 0;
+        while (ms > latency_limits[b]) b++;
+        h->buckets[b]++;
+        h->count++;
+        h->total_ms += ms;
+        if (ms > h->max_ms) h->max_ms = ms;
     }
+    latency_pending_count = 0;
+}
 
-    if (e.type == SDL_MOUSEBUTTONDOWN) {
-      int btn_idx =
-          e.button.button -
-          1; // Internal indexing: 0 for left, 1 for middle, 2 for right
-      if (btn_idx >= 0 && btn_idx < 8) {
-        engine.mouse_buttons[btn_idx] = 1;
-      }
+static Uint32 _latency_percentile(const LatencyHistogram* h, float p) {
+    Uint32 target = (Uint32)ceilf(h->count * p);
+    Uint32 seen = 0;
+    for (int b = 0; b < UI_LATENCY_BUCKETS; b++) {
+        seen += h->buckets[b];
+        if (seen >= target && seen > 0) return latency_limits[b] < h->max_ms ? latency_limits[b] : h->max_ms;
+    }
+    return h->max_ms;
+}
 
-      UIElement *hit = _get_hit(engine.root, mx, my, 0, 0);
+void sxui_get_latency(UILatencyKind kind, UILatencyStats* out) {
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    if ((unsigned)kind >= UI_LATENCY_KINDS) return;
+    const LatencyHistogram* h = &latency_hist[kind];
+    out->count = h->count;
+    out->max_ms = h->max_ms;
+    out->mean_ms = h->count ? (float)h->total_ms / h->count : 0;
+    out->p50_ms = _latency_percentile(h, 0.50f);
+    out->p95_ms = _latency_percentile(h, 0.95f);
+    out->p99_ms = _latency_percentile(h, 0.99f);
+    memcpy(out->bucket_limit_ms, latency_limits, sizeof(latency_limits));
+    memcpy(out->buckets, h->buckets, sizeof(h->buckets));
+}
 
-      // Special case: check focused dropdown first to handle popups outside
-      // parent bounds
-      if (!hit && engine.focused && engine.focused->type == UI_DROPDOWN) {
-        UIDropdown *dd = (UIDropdown *)engine.focused;
-        if (dd->is_open) {
-          int wx, wy;
-          sxui_get_abs_pos(engine.focused, &wx, &wy);
-          int dropdown_h = 30 + (dd->option_count * 30);
-          if (mx >= wx && mx <= wx + engine.focused->w && my >= wy &&
-              my <= wy + dropdown_h) {
-            hit = engine.focused;
-          }
-        }
-      }
+void sxui_reset_latency(void) {
+    memset(latency_hist, 0, sizeof(latency_hist));
+    latency_pending_count = 0;
+}
 
-      engine.mouse_pressed_element = hit;
-      engine.mouse_pressed_button = e.button.button;
+void sxui_set_low_latency(int enabled) {
+    latency_low = enabled;
+}
 
-      if (engine.focused && engine.focused != hit) {
-        if (engine.focused->type == UI_INPUT) {
-          trigger_focus((UITextInput *)engine.focused, 0);
-          SDL_StopTextInput();
-        }
-        if (engine.focused->type == UI_DROPDOWN) {
-          ((UIDropdown *)engine.focused)->is_open = 0;
-        }
-        engine.focused = NULL;
-      }
+void sxui_set_profiler_overlay(int enabled) {
+    latency_overlay = enabled;
+}
 
-      if (hit) {
-        if (hit->flags & UI_FLAG_DRAGGABLE) {
-          engine.dragging_el = hit;
-          engine.drag_off_x = mx - hit->x;
-          engine.drag_off_y = my - hit->y;
+static void _latency_draw_overlay(void) {
+    static const char* names[UI_LATENCY_KINDS] = {"motion", "button", "wheel", "key", "text"};
+    int w, h;
+    SDL_GetWindowSize(engine.window, &w, &h);
+    SDL_Rect panel = {w - 350, 10, 340, 36 + 22 * UI_LATENCY_KINDS};
+    SDL_SetRenderDrawBlendMode(engine.renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(engine.renderer, 0, 0, 0, 200);
+    SDL_RenderFillRect(engine.renderer, &panel);
+
+    static const char* heads[5] = {"input->present", "n", "p50", "p95", "max"};
+    static const int cols[5] = {10, 140, 210, 250, 290};
+    int y = panel.y + 16;
+    for (int c = 0; c < 5; c++) _draw_text(heads[c], panel.x + cols[c], y, 0xFFFFFFFF, 0, 0);
+    for (int k = 0; k < UI_LATENCY_KINDS; k++) {
+        UILatencyStats s;
+        sxui_get_latency((UILatencyKind)k, &s);
+        Uint32 values[4] = {s.count, s.p50_ms, s.p95_ms, s.max_ms};
+        char num[16];
+        y += 22;
+        _draw_text(names[k], panel.x + cols[0], y, 0xC8C8C8FF, 0, 0);
+        for (int c = 0; c < 4; c++) {
+            snprintf(num, sizeof(num), "%u", (unsigned)values[c]);
+            _draw_text(num, panel.x + cols[c + 1], y, 0xC8C8C8FF, 0, 0);
         }
+    }
+}
 
-        if (hit->type == UI_BUTTON) {
-          UIButton *b = (UIButton *)hit;
-          b->_pressed = 1;
-          b->_lastClickTime = SDL_GetTicks();
-          trigger_click(b);
-        } else if (hit->type == UI_CHECKBOX) {
-          UICheckBox *cb = (UICheckBox *)hit;
-          cb->value = !cb->value;
-          trigger_value_changed(cb, (float)cb->value);
-        } else if (hit->type == UI_SLIDER) {
-          engine.focused = hit;
-        } else if (hit->type == UI_DROPDOWN) {
-          UIDropdown *dd = (UIDropdown *)hit;
-          int wx, wy;
-          sxui_get_abs_pos(hit, &wx, &wy);
-          int header_h = 30;
+// --- Recording ---
+// A session file is "SXRP", a version byte, then one record per frame
+// marker or consumed event: a kind byte, the time since the previous record
+// in ms, and the event's fields, all as zigzag varints. Frame markers are
+// written at the start of each sxui_poll_events, so a replay hands the app
+// exactly the batches it saw while recording.
+#define SESSION_MAGIC "SXRP"
+#define SESSION_VERSION 1
+
+enum {
+    REC_FRAME,
+    REC_QUIT,
+    REC_MOTION,
+    REC_BUTTON_DOWN,
+    REC_BUTTON_UP,
+    REC_WHEEL,
+    REC_KEY_DOWN,
+    REC_KEY_UP,
+    REC_TEXT,
+    REC_WINDOW,
+    REC_DROP
+};
 
-          if (my < wy + header_h) {
-            dd->is_open = !dd->is_open;
-            engine.focused = (UIElement *)dd;
-          } else if (dd->is_open) {
-            int item_idx = (my - (wy + header_h)) / 30;
-            if (item_idx >= 0 && item_idx < dd->option_count) {
-              dd->selected_index = item_idx;
-              dd->is_open = 0;
-              trigger_dropdown_changed(dd, item_idx, dd->options[item_idx]);
->>>>>>> 410878f (feat: Add new pages and enhance input handling)
-            }
-            
-            SDL_free(dropped_file);
+static FILE* record_file = NULL;
+static Uint32 record_time = 0;
+
+static struct {
+    Uint8* data;
+    size_t size;
+    size_t pos;
+    Uint32 time;
+    int mouse_x, mouse_y;
+    Uint32 mouse_buttons;
+} replay;
+
+static void _rec_int(Sint32 v) {
+    Uint32 z = ((Uint32)v << 1) ^ (Uint32)(v >> 31);
+    while (z >= 0x80) {
+        fputc((int)(z & 0x7F) | 0x80, record_file);
+        z >>= 7;
+    }
+    fputc((int)z, record_file);
+}
+
+static void _rec_bytes(const char* s, int len) {
+    _rec_int(len);
+    fwrite(s, 1, len, record_file);
+}
+
+static void _rec_header(int kind, Uint32 time) {
+    fputc(kind, record_file);
+    _rec_int((Sint32)(time - record_time));
+    record_time = time;
+}
+
+static void _record_event(const SDL_Event* e) {
+    switch (e->type) {
+        case SDL_QUIT:
+            _rec_header(REC_QUIT, e->common.timestamp);
+            break;
+        case SDL_MOUSEMOTION:
+            _rec_header(REC_MOTION, e->common.timestamp);
+            _rec_int(e->motion.x);
+            _rec_int(e->motion.y);
+            _rec_int(e->motion.xrel);
+            _rec_int(e->motion.yrel);
+            _rec_int((Sint32)e->motion.state);
+            break;
+        case SDL_MOUSEBUTTONDOWN:
+        case SDL_MOUSEBUTTONUP:
+            _rec_header(e->type == SDL_MOUSEBUTTONDOWN ? REC_BUTTON_DOWN : REC_BUTTON_UP, e->common.timestamp);
+            _rec_int(e->button.button);
+            _rec_int(e->button.clicks);
+            _rec_int(e->button.x);
+            _rec_int(e->button.y);
+            break;
+        case SDL_MOUSEWHEEL:
+            _rec_header(REC_WHEEL, e->common.timestamp);
+            _rec_int(e->wheel.x);
+            _rec_int(e->wheel.y);
+            _rec_int((Sint32)e->wheel.direction);
+            break;
+        case SDL_KEYDOWN:
+        case SDL_KEYUP:
+            _rec_header(e->type == SDL_KEYDOWN ? REC_KEY_DOWN : REC_KEY_UP, e->common.timestamp);
+            _rec_int(e->key.keysym.scancode);
+            _rec_int(e->key.keysym.sym);
+            _rec_int(e->key.keysym.mod);
+            _rec_int(e->key.repeat);
+            break;
+        case SDL_TEXTINPUT:
+            _rec_header(REC_TEXT, e->common.timestamp);
+            _rec_bytes(e->text.text, (int)strlen(e->text.text));
+            break;
+        case SDL_WINDOWEVENT:
+            _rec_header(REC_WINDOW, e->common.timestamp);
+            _rec_int(e->window.event);
+            _rec_int(e->window.data1);
+            _rec_int(e->window.data2);
+            break;
+        case SDL_DROPFILE:
+            _rec_header(REC_DROP, e->common.timestamp);
+            _rec_bytes(e->drop.file, (int)strlen(e->drop.file));
+            break;
+        default:
+            break;   // wake events and anything the UI does not consume
+    }
+}
+
+int sxui_record_begin(const char* path) {
+    sxui_record_end();
+    record_file = fopen(path, "wb");
+    if (!record_file) return 0;
+    fwrite(SESSION_MAGIC, 1, 4, record_file);
+    fputc(SESSION_VERSION, record_file);
+    record_time = _clock_ticks();
+    return 1;
+}
+
+void sxui_record_end(void) {
+    if (!record_file) return;
+    fclose(record_file);
+    record_file = NULL;
+}
+
+// Reads one zigzag varint; a truncated file reads as the end of the session.
+static int _replay_int(Sint32* out) {
+    Uint32 z = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (replay.pos >= replay.size) return 0;
+        Uint8 b = replay.data[replay.pos++];
+        z |= (Uint32)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *out = (Sint32)(z >> 1) ^ -(Sint32)(z & 1);
+            return 1;
         }
+    }
+    return 0;
+}
+
+static void _replay_stop(void) {
+    free(replay.data);
+    memset(&replay, 0, sizeof(replay));
+    if (clock_virtual) {
+        Uint32 ticks = clock_ticks;
+        Uint64 counter = _clock_counter();
+        clock_virtual = 0;
+        if ((Sint32)(ticks - _clock_ticks()) > 0) clock_offset += ticks - _clock_ticks();
+        if (counter > _clock_counter()) clock_counter_offset += counter - _clock_counter();
+    }
+}
 
-        if (e.type == SDL_MOUSEBUTTONDOWN) {
-            UIElement* hit = _get_hit(engine.root, mx, my, 0, 0);
-            int clicked_ui = (hit != NULL);
+int sxui_replay(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return 0;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    Uint8* data = size > 5 ? malloc((size_t)size) : NULL;
+    if (!data || fread(data, 1, (size_t)size, f) != (size_t)size ||
+        memcmp(data, SESSION_MAGIC, 4) != 0 || data[4] != SESSION_VERSION) {
+        free(data);
+        fclose(f);
+        return 0;
+    }
+    fclose(f);
+
+    _replay_stop();
+    replay.data = data;
+    replay.size = (size_t)size;
+    replay.pos = 5;
+    // Start on a whole second so blink phases match from run to run.
+    clock_origin = (_clock_ticks() / 1000 + 1) * 1000;
+    clock_origin_counter = _clock_counter();
+    clock_ticks = clock_origin;
+    clock_virtual = 1;
+    replay.time = clock_origin;
+    return 1;
+}
+
+int sxui_is_replaying(void) {
+    return replay.data != NULL;
+}
+
+// Called at the start of each poll: while replaying, consumes the frame
+// marker and moves the virtual clock to it; while recording, writes one.
+static void _session_frame(void) {
+    if (replay.data) {
+        Sint32 dt;
+        if (replay.pos >= replay.size || replay.data[replay.pos] != REC_FRAME) {
+            _replay_stop();
+        } else {
+            replay.pos++;
+            if (!_replay_int(&dt)) {
+                _replay_stop();
+            } else {
+                replay.time += (Uint32)dt;
+                clock_ticks = replay.time;
+            }
+        }
+    }
+    if (record_file) _rec_header(REC_FRAME, _clock_ticks());
+}
+
+// SDL_GetMouseState reports the live pointer, which replayed events never
+// move, so the UI asks here instead.
+static Uint32 _mouse_state(int* x, int* y) {
+    if (!replay.data) return SDL_GetMouseState(x, y);
+    if (x) *x = replay.mouse_x;
+    if (y) *y = replay.mouse_y;
+    return replay.mouse_buttons;
+}
+
+static int _replay_truncated(void) {
+    replay.pos = replay.size;
+    return 0;
+}
+
+// Decodes the next recorded event of the current frame into e. Returns 0
+// at the next frame marker or the end of the session.
+static int _replay_event(SDL_Event* e) {
+    Sint32 kind, dt, v[5];
+    if (replay.pos >= replay.size || replay.data[replay.pos] == REC_FRAME) return 0;
+    kind = replay.data[replay.pos++];
+    if (!_replay_int(&dt)) return _replay_truncated();
+    replay.time += (Uint32)dt;
+
+    memset(e, 0, sizeof(*e));
+    e->common.timestamp = replay.time;
+    int fields = 0;
+    switch (kind) {
+        case REC_QUIT: e->type = SDL_QUIT; break;
+        case REC_MOTION: e->type = SDL_MOUSEMOTION; fields = 5; break;
+        case REC_BUTTON_DOWN: e->type = SDL_MOUSEBUTTONDOWN; fields = 4; break;
+        case REC_BUTTON_UP: e->type = SDL_MOUSEBUTTONUP; fields = 4; break;
+        case REC_WHEEL: e->type = SDL_MOUSEWHEEL; fields = 3; break;
+        case REC_KEY_DOWN: e->type = SDL_KEYDOWN; fields = 4; break;
+        case REC_KEY_UP: e->type = SDL_KEYUP; fields = 4; break;
+        case REC_WINDOW: e->type = SDL_WINDOWEVENT; fields = 3; break;
+        case REC_TEXT: e->type = SDL_TEXTINPUT; fields = 1; break;
+        case REC_DROP: e->type = SDL_DROPFILE; fields = 1; break;
+        default: return _replay_truncated();
+    }
+    for (int i = 0; i < fields; i++) {
+        if (!_replay_int(&v[i])) return _replay_truncated();
+    }
+
+    switch (kind) {
+        case REC_MOTION:
+            e->motion.x = v[0];
+            e->motion.y = v[1];
+            e->motion.xrel = v[2];
+            e->motion.yrel = v[3];
+            e->motion.state = (Uint32)v[4];
+            replay.mouse_x = v[0];
+            replay.mouse_y = v[1];
+            break;
+        case REC_BUTTON_DOWN:
+        case REC_BUTTON_UP:
+            e->button.button = (Uint8)v[0];
+            e->button.clicks = (Uint8)v[1];
+            e->button.x = v[2];
+            e->button.y = v[3];
+            e->button.state = kind == REC_BUTTON_DOWN ? SDL_PRESSED : SDL_RELEASED;
+            replay.mouse_x = v[2];
+            replay.mouse_y = v[3];
+            if (v[0] >= 1 && v[0] <= 32) {
+                if (kind == REC_BUTTON_DOWN) replay.mouse_buttons |= SDL_BUTTON(v[0]);
+                else replay.mouse_buttons &= ~SDL_BUTTON(v[0]);
+            }
+            break;
+        case REC_WHEEL:
+            e->wheel.x = v[0];
+            e->wheel.y = v[1];
+            e->wheel.direction = (Uint32)v[2];
+            break;
+        case REC_KEY_DOWN:
+        case REC_KEY_UP:
+            e->key.keysym.scancode = (SDL_Scancode)v[0];
+            e->key.keysym.sym = v[1];
+            e->key.keysym.mod = (Uint16)v[2];
+            e->key.repeat = (Uint8)v[3];
+            e->key.state = kind == REC_KEY_DOWN ? SDL_PRESSED : SDL_RELEASED;
+            break;
+        case REC_WINDOW:
+            e->window.event = (Uint8)v[0];
+            e->window.data1 = v[1];
+            e->window.data2 = v[2];
+            // Resizes are replayed on the real window so constraints refit.
+            if (e->window.event == SDL_WINDOWEVENT_RESIZED) SDL_SetWindowSize(engine.window, v[1], v[2]);
+            break;
+        case REC_TEXT:
+            if (v[0] < 0 || v[0] >= (Sint32)sizeof(e->text.text) || replay.size - replay.pos < (size_t)v[0]) return _replay_truncated();
+            memcpy(e->text.text, replay.data + replay.pos, v[0]);
+            replay.pos += v[0];
+            break;
+        case REC_DROP:
+            if (v[0] < 0 || replay.size - replay.pos < (size_t)v[0]) return _replay_truncated();
+            e->drop.file = SDL_malloc(v[0] + 1);
+            if (!e->drop.file) return _replay_truncated();
+            memcpy(e->drop.file, replay.data + replay.pos, v[0]);
+            e->drop.file[v[0]] = '\0';
+            replay.pos += v[0];
+            break;
+    }
+    return 1;
+}
+
+static int _poll_event(SDL_Event* e) {
+    poll_started = SDL_GetTicks();
+    in_poll = 1;
+    int pending = SDL_PollEvent(e);
+    int replayed = 0;
+    in_poll = 0;
+    if (replay.data) {
+        // Live input is dropped while replaying; quitting and posts still work.
+        while (pending && e->type != SDL_QUIT && e->type != post_event) {
+            in_poll = 1;
+            pending = SDL_PollEvent(e);
+            in_poll = 0;
+        }
+        if (!pending) pending = replayed = _replay_event(e);
+    }
+    if (pending) {
+        // Replayed events carry recorded times; their latency starts now.
+        event_time = replayed ? SDL_GetTicks() : e->common.timestamp;
+        _latency_note(e, event_time);
+        if (record_file) _record_event(e);
+    }
+    return pending;
+}
+
+// --- Kinetic scrolling ---
+
+// Wheel ticks add velocity instead of jumping. Velocity decays
+// exponentially with time constant SCROLL_DECAY, and the integration is
+// exact for any frame time, so a tick travels SCROLL_STEP pixels whatever
+// the frame rate. Snapping frames then ease onto the nearest snap point.
+#define SCROLL_STEP 40
+#define SCROLL_DECAY 0.1f
+#define SCROLL_MIN_SPEED 8.0f
+#define SCROLL_SNAP_TIME 0.06f
+
+static list* scrolling_frames = NULL;
+static Uint64 scroll_last_counter = 0;
+
+static int _scroll_axis(float* pos, float* vel, int snap, int max, float dt) {
+    if (max < 0) max = 0;
+    float decay = expf(-dt / SCROLL_DECAY);
+    *pos += *vel * SCROLL_DECAY * (1.0f - decay);
+    *vel *= decay;
+    if (*pos <= 0 || *pos >= max) {
+        *pos = *pos <= 0 ? 0 : (float)max;
+        *vel = 0;
+    }
+    if (fabsf(*vel) > SCROLL_MIN_SPEED) return 1;
+    *vel = 0;
+    if (snap > 0) {
+        float target = roundf(*pos / snap) * snap;
+        if (target > max) target = (float)max;
+        if (fabsf(target - *pos) > 0.5f) {
+            *pos += (target - *pos) * (1.0f - expf(-dt / SCROLL_SNAP_TIME));
+            return 1;
+        }
+        *pos = target;
+    }
+    return 0;
+}
+
+static int _scroll_advance(UIFrame* f, float dt) {
+    int moving = _scroll_axis(&f->scroll_fx, &f->scroll_vx, f->snap_x, f->content_width - f->el.w, dt);
+    moving |= _scroll_axis(&f->scroll_fy, &f->scroll_vy, f->snap_y, f->content_height - f->el.h, dt);
+    f->scroll_x = (int)lroundf(f->scroll_fx);
+    f->scroll_y = (int)lroundf(f->scroll_fy);
+    f->last_scroll_time = _clock_ticks();
+    return moving;
+}
+
+static void _scroll_start(UIFrame* f) {
+    if (f->scroll_moving) return;
+    f->scroll_fx = (float)f->scroll_x;
+    f->scroll_fy = (float)f->scroll_y;
+    f->scroll_moving = 1;
+    if (!scrolling_frames) scrolling_frames = list_new();
+    list_add(scrolling_frames, f);
+}
+
+static void _scroll_stop(UIFrame* f) {
+    if (!f->scroll_moving) return;
+    f->scroll_moving = 0;
+    f->scroll_vx = f->scroll_vy = 0;
+    list_remove(scrolling_frames, f);
+}
+
+static void _scroll_set(UIFrame* f, int x, int y) {
+    _scroll_stop(f);
+    int max_x = f->content_width - f->el.w, max_y = f->content_height - f->el.h;
+    f->scroll_x = x > max_x ? max_x : x;
+    f->scroll_y = y > max_y ? max_y : y;
+    if (f->scroll_x < 0) f->scroll_x = 0;
+    if (f->scroll_y < 0) f->scroll_y = 0;
+    f->last_scroll_time = _clock_ticks();
+}
+
+// Frames scrollable on one axis only take the vertical wheel on that axis.
+static void _scroll_wheel(UIFrame* f, int wheel_x, int wheel_y) {
+    float dx = (float)wheel_x, dy = (float)-wheel_y;
+    if (!(f->el.flags & UI_SCROLLABLE)) {
+        if (!wheel_x) dx = dy;
+        dy = 0;
+    }
+    if (!(f->el.flags & UI_SCROLLABLE_X)) dx = 0;
+    if (dx == 0 && dy == 0) return;
+    _scroll_start(f);
+    f->scroll_vx += dx * SCROLL_STEP / SCROLL_DECAY;
+    f->scroll_vy += dy * SCROLL_STEP / SCROLL_DECAY;
+}
+
+// Advances every frame in motion by the real time since the previous
+// frame. Long stalls are capped so a hitch does not fling the content.
+static void _scroll_step(void) {
+    if (!scrolling_frames || list_length(scrolling_frames) == 0) {
+        scroll_last_counter = 0;
+        return;
+    }
+    Uint64 now = _clock_counter();
+    float dt = scroll_last_counter ? (float)(now - scroll_last_counter) / SDL_GetPerformanceFrequency() : 1.0f / 60;
+    if (dt > 0.1f) dt = 0.1f;
+    scroll_last_counter = now;
+
+    for (int i = (int)list_length(scrolling_frames) - 1; i >= 0; i--) {
+        UIFrame* f = list_get(scrolling_frames, i);
+        if (!_scroll_advance(f, dt)) _scroll_stop(f);
+    }
+}
+
+int sxui_is_scrolling(void) {
+    return scrolling_frames && list_length(scrolling_frames) > 0;
+}
+
+// --- Hit testing ---
+
+// Every element with children keeps a hit index over them: the visible
+// children ordered topmost first and, past HIT_GRID_MIN children, a uniform
+// grid of their rects in parent-local coordinates. Scrolling only shifts the
+// query point, so the index is rebuilt lazily on the first query after a
+// child is added, removed, moved, resized, hidden or laid out.
+#define HIT_GRID_MIN 16
+#define HIT_CELL_ITEMS 4
+#define HIT_MAX_CELLS 4096
+
+struct UIHitIndex {
+    int dirty;
+    int count, order_cap;
+    UIElement** order;
+    int cols, rows, cell, ox, oy;
+    int cells_cap, items_cap;
+    int* cell_start;
+    int* cell_items;
+};
+
+typedef struct {
+    UIElement* el;
+    int index;
+} HitSlot;
+
+static UIHitIndex root_hits = {.dirty = 1};
+static HitSlot* hit_slots = NULL;
+static int hit_slot_cap = 0;
+
+static void _hit_invalidate(UIElement* container) {
+    UIHitIndex* h = container ? container->hits : &root_hits;
+    if (h) h->dirty = 1;
+}
+
+static void _hit_index_release(UIHitIndex* h) {
+    free(h->order);
+    free(h->cell_start);
+    free(h->cell_items);
+}
+
+static void _hit_index_free(UIElement* el) {
+    if (!el->hits) return;
+    _hit_index_release(el->hits);
+    free(el->hits);
+    el->hits = NULL;
+}
+
+// Topmost first: higher z-index, then newer elements, then later siblings.
+static int _hit_cmp(const void* a, const void* b) {
+    const HitSlot* sa = a;
+    const HitSlot* sb = b;
+    if (sa->el->z_index != sb->el->z_index) return sb->el->z_index - sa->el->z_index;
+    if (sa->el->creation_time != sb->el->creation_time)
+        return sb->el->creation_time > sa->el->creation_time ? 1 : -1;
+    return sb->index - sa->index;
+}
+
+static int _hit_reserve(void** buf, int* cap, int n, size_t size) {
+    if (n <= *cap) return 1;
+    int grown = *cap ? *cap : 16;
+    while (grown < n) grown *= 2;
+    void* p = realloc(*buf, grown * size);
+    if (!p) return 0;
+    *buf = p;
+    *cap = grown;
+    return 1;
+}
+
+static void _hit_cells(UIHitIndex* h, UIElement* e, int* c0, int* c1, int* r0, int* r1) {
+    *c0 = (e->x - h->ox) / h->cell;
+    *r0 = (e->y - h->oy) / h->cell;
+    *c1 = (e->x + (e->w > 0 ? e->w : 0) - h->ox) / h->cell;
+    *r1 = (e->y + (e->h > 0 ? e->h : 0) - h->oy) / h->cell;
+}
+
+static void _hit_build(UIHitIndex* h, list* l) {
+    int n = list_length(l);
+    h->count = 0;
+    h->cols = 0;
+    h->dirty = 0;
+    if (!_hit_reserve((void**)&hit_slots, &hit_slot_cap, n, sizeof(HitSlot)) ||
+        !_hit_reserve((void**)&h->order, &h->order_cap, n, sizeof(UIElement*))) {
+        h->dirty = 1;
+        return;
+    }
+
+    int count = 0;
+    for (int i = 0; i < n; i++) {
+        UIElement* e = list_get(l, i);
+        if (e->flags & UI_FLAG_HIDDEN) continue;
+        hit_slots[count].el = e;
+        hit_slots[count].index = i;
+        count++;
+    }
+    qsort(hit_slots, count, sizeof(HitSlot), _hit_cmp);
+    for (int i = 0; i < count; i++) h->order[i] = hit_slots[i].el;
+    h->count = count;
+    if (count < HIT_GRID_MIN) return;
+
+    int min_x = INT_MAX, min_y = INT_MAX, max_x = INT_MIN, max_y = INT_MIN;
+    for (int i = 0; i < count; i++) {
+        UIElement* e = h->order[i];
+        if (e->x < min_x) min_x = e->x;
+        if (e->y < min_y) min_y = e->y;
+        if (e->x + e->w > max_x) max_x = e->x + e->w;
+        if (e->y + e->h > max_y) max_y = e->y + e->h;
+    }
+    double span_w = (double)max_x - min_x + 1, span_h = (double)max_y - min_y + 1;
+    int cells = count / HIT_CELL_ITEMS;
+    if (cells > HIT_MAX_CELLS) cells = HIT_MAX_CELLS;
+    double cell = ceil(sqrt(span_w * span_h / cells));
+    if (cell < 8) cell = 8;
+    if (span_w / cell > HIT_MAX_CELLS) cell = ceil(span_w / HIT_MAX_CELLS);
+    if (span_h / cell > HIT_MAX_CELLS) cell = ceil(span_h / HIT_MAX_CELLS);
+    h->cell = (int)cell;
+    h->ox = min_x;
+    h->oy = min_y;
+    h->cols = (int)((span_w - 1) / cell) + 1;
+    h->rows = (int)((span_h - 1) / cell) + 1;
+
+    // Bucket the children into the cells they overlap, CSR style. Entries
+    // are visited topmost first, so every cell lists its children in order.
+    int total_cells = h->cols * h->rows;
+    if (!_hit_reserve((void**)&h->cell_start, &h->cells_cap, total_cells + 1, sizeof(int))) {
+        h->cols = 0;
+        return;
+    }
+    memset(h->cell_start, 0, (total_cells + 1) * sizeof(int));
+    int c0, c1, r0, r1;
+    for (int i = 0; i < count; i++) {
+        _hit_cells(h, h->order[i], &c0, &c1, &r0, &r1);
+        for (int r = r0; r <= r1; r++)
+            for (int c = c0; c <= c1; c++) h->cell_start[r * h->cols + c + 1]++;
+    }
+    for (int c = 0; c < total_cells; c++) h->cell_start[c + 1] += h->cell_start[c];
+    if (!_hit_reserve((void**)&h->cell_items, &h->items_cap, h->cell_start[total_cells], sizeof(int))) {
+        h->cols = 0;
+        return;
+    }
+    for (int i = 0; i < count; i++) {
+        _hit_cells(h, h->order[i], &c0, &c1, &r0, &r1);
+        for (int r = r0; r <= r1; r++)
+            for (int c = c0; c <= c1; c++) h->cell_items[h->cell_start[r * h->cols + c]++] = i;
+    }
+    for (int c = total_cells; c > 0; c--) h->cell_start[c] = h->cell_start[c - 1];
+    h->cell_start[0] = 0;
+}
+
+// Descends only into children whose parent was hit, so a child never
+// answers outside its parent's rect and clipping frames clip hits too.
+static UIElement* _hit_walk(UIElement* container, list* l, int mx, int my, int px, int py) {
+    if (list_length(l) == 0) return NULL;
+    UIHitIndex* h = container ? container->hits : &root_hits;
+    if (!h) {
+        h = calloc(1, sizeof(UIHitIndex));
+        if (!h) return NULL;
+        h->dirty = 1;
+        container->hits = h;
+    }
+    if (h->dirty) _hit_build(h, l);
+
+    int lx = mx - px, ly = my - py;
+    int* items = NULL;
+    int n = h->count;
+    if (h->cols) {
+        int c = lx - h->ox, r = ly - h->oy;
+        if (c < 0 || r < 0) return NULL;
+        c /= h->cell;
+        r /= h->cell;
+        if (c >= h->cols || r >= h->rows) return NULL;
+        int cell = r * h->cols + c;
+        items = h->cell_items + h->cell_start[cell];
+        n = h->cell_start[cell + 1] - h->cell_start[cell];
+    }
+
+    for (int i = 0; i < n; i++) {
+        UIElement* e = h->order[items ? items[i] : i];
+        if (lx < e->x || lx > e->x + e->w || ly < e->y || ly > e->y + e->h) continue;
+
+        UIElement* child = NULL;
+        if (list_length(e->children) > 0) {
+            int sx = 0, sy = 0;
+            if (e->type == UI_FRAME) {
+                sx = ((UIFrame*)e)->scroll_x;
+                sy = ((UIFrame*)e)->scroll_y;
+            }
+            child = _hit_walk(e, e->children, mx, my, px + e->x - sx, py + e->y - sy);
+        }
+        return child ? child : e;
+    }
+    return NULL;
+}
+
+// An open dropdown's option list hangs below its header, outside its own
+// rect and often outside its parent's, so it is tested before the tree.
+// Hidden or clipping ancestors still cut it off.
+static int _hit_dropdown_popup(UIElement* e, int mx, int my) {
+    if (e->flags & UI_FLAG_HIDDEN) return 0;
+    SDL_Rect r = {e->x, e->y, e->w, 30 + ((UIDropdown*)e)->option_count * 30};
+    for (UIElement* p = e->parent; p; p = p->parent) {
+        if (p->flags & UI_FLAG_HIDDEN) return 0;
+        if (p->type == UI_FRAME) {
+            r.x -= ((UIFrame*)p)->scroll_x;
+            r.y -= ((UIFrame*)p)->scroll_y;
+        }
+        if (p->flags & UI_FLAG_CLIP) {
+            SDL_Rect bounds = {0, 0, p->w, p->h};
+            if (!SDL_IntersectRect(&r, &bounds, &r)) return 0;
+        }
+        r.x += p->x;
+        r.y += p->y;
+    }
+    return mx >= r.x && mx <= r.x + r.w && my >= r.y && my <= r.y + r.h;
+}
+
+UIElement* _hit_test(int mx, int my) {
+    UIElement* f = engine.focused;
+    if (f && f->type == UI_DROPDOWN && ((UIDropdown*)f)->is_open && _hit_dropdown_popup(f, mx, my)) return f;
+    return _hit_walk(NULL, engine.root, mx, my, 0, 0);
+}
+
+// --- Hover ---
+// Hover is resolved once per sxui_poll_events from the last mouse position
+// of the batch. One hit test gives the topmost element under the cursor; it
+// and its ancestors form the hovered chain, so clipped and occluded elements
+// are never hovered. Enter/leave only fire for elements joining or leaving
+// the chain, and the renderer just reads _is_hovered.
+
+#define HOVER_DEPTH 64
+
+// Both chains are static so deleting an element from an enter/leave callback
+// can clear it from the pass still in progress.
+static UIElement* hover_chain[HOVER_DEPTH];
+static UIElement* hover_left[HOVER_DEPTH];
+static int hover_count = 0;
+static int hover_left_count = 0;
+static int hover_outside = 0;
+
+static int _hover_find(UIElement** chain, int n, UIElement* el) {
+    for (int i = 0; i < n; i++) {
+        if (chain[i] == el) return 1;
+    }
+    return 0;
+}
+
+static void _hover_update(int mx, int my) {
+    hover_left_count = 0;
+    for (int i = 0; i < hover_count; i++) {
+        if (hover_chain[i]) hover_left[hover_left_count++] = hover_chain[i];
+    }
+    hover_count = 0;
+    UIElement* hit = hover_outside ? NULL : _hit_test(mx, my);
+    for (UIElement* e = hit; e && hover_count < HOVER_DEPTH; e = e->parent) hover_chain[hover_count++] = e;
+
+    // Leaves go innermost first and enters outermost first, like nesting.
+    for (int i = 0; i < hover_left_count; i++) {
+        UIElement* e = hover_left[i];
+        if (!e || _hover_find(hover_chain, hover_count, e)) continue;
+        e->_is_hovered = 0;
+        trigger_hover(e, 0);
+    }
+    for (int i = hover_count - 1; i >= 0; i--) {
+        UIElement* e = hover_chain[i];
+        if (!e || _hover_find(hover_left, hover_left_count, e)) continue;
+        e->_is_hovered = 1;
+        trigger_hover(e, 1);
+    }
+    hover_left_count = 0;
+}
+
+static void _hover_forget(UIElement* el) {
+    for (int i = 0; i < hover_count; i++) {
+        if (hover_chain[i] == el) hover_chain[i] = NULL;
+    }
+    for (int i = 0; i < hover_left_count; i++) {
+        if (hover_left[i] == el) hover_left[i] = NULL;
+    }
+}
+
+void init_base(UIElement* el, int x, int y, int w, int h, UIType t) {
+    el->x = x;
+    el->y = y;
+    el->w = w;
+    el->h = h;
+    el->type = t;
+    el->flags = UI_FLAG_NONE;
+    el->parent = NULL;
+    el->children = list_new();
+    el->_is_hovered = 0;
+    el->_is_dragging = 0;
+    el->z_index = 0;
+    el->creation_time = _clock_ticks();
+    el->transparency = 1.0f;
+    el->custom_color = SX_COLOR_NONE;
+    el->has_custom_color = 0;
+    el->onMouseEnter = NULL;
+    el->onMouseLeave = NULL;
+    
+    el->effects.gradient.enabled = 0;
+    el->effects.gradient.stops = NULL;
+    el->effects.gradient.angle = 90.0f;
+    el->effects.outline.enabled = 0;
+    el->effects.outline.width = 1;
+    el->effects.outline.color = SX_COLOR_BLACK;
+    el->effects.outline.alpha = 255;
+    el->effects.rounded.enabled = 0;
+    el->effects.rounded.radius = 0;
+}
+
+void _add_to_parent(UIElement* p, UIElement* c) {
+    if (p) {
+        c->parent = p;
+        list_add(p->children, c);
+        _layout_invalidate(p, list_length(p->children) - 1);
+    } else {
+        list_add(engine.root, c);
+        _hit_invalidate(NULL);
+    }
+}
+
+<<<<<<< HEAD
+void sxui_init(const char* title, int w, int h, Uint32 seed) {
+    SDL_Init(SDL_INIT_VIDEO);
+    TTF_Init();
+    
+    engine.window = SDL_CreateWindow(title, SDL_WINDOWPOS_CENTERED, 
+                                     SDL_WINDOWPOS_CENTERED, w, h, SDL_WINDOW_SHOWN);
+    engine.renderer = SDL_CreateRenderer(engine.window, -1, 
+                                        SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    SDL_EventState(SDL_DROPFILE, SDL_ENABLE);
+    main_thread_id = SDL_ThreadID();
+    _posts_init();
+    SDL_AddEventWatch(_resize_watch, NULL);
+
+    engine.default_font = TTF_OpenFont("fonts/Montserrat-Regular.ttf", 16);
+    if (!engine.default_font) {
+        printf("Warning: Could not load fallback font Montserrat.\n");
+    }
+    engine.custom_font = NULL;
+    
+    engine.root = list_new();
+    engine.theme = sx_generate_palette(seed, THEME_DARK);
+    engine.running = 1;
+    engine.focused = NULL;
+    engine.dragging_el = NULL;
+    engine.page_manager.pages = NULL;
+    engine.page_manager.current_page = -1;
+    engine.page_manager.initialized = 0;
+    engine.file_drop_callback = NULL;
+}
+
+int sxui_load_font(const char* path, int size) {
+    if (engine.custom_font) {
+        _glyph_cache_drop(engine.custom_font);
+        TTF_CloseFont(engine.custom_font);
+    }
+    engine.custom_font = TTF_OpenFont(path, size);
+    _text_size_font_changed();
+    return (engine.custom_font != NULL);
+=======
+void init_base(UIElement *el, int x, int y, int w, int h, UIType t) {
+  el->x = x;
+  el->y = y;
+  el->w = w;
+  el->h = h;
+  el->type = t;
+  engine.last_created = el;
+  el->flags = UI_FLAG_NONE;
+  el->parent = NULL;
+  el->children = list_new();
+  el->_is_hovered = 0;
+  el->_is_dragging = 0;
+  el->z_index = 0;
+  el->creation_time = _clock_ticks();
+  el->transparency = 1.0f;
+  el->custom_color = SX_COLOR_NONE;
+  el->has_custom_color = 0;
+  el->onMouseEnter = NULL;
+  el->onMouseLeave = NULL;
+  el->onMouseClick = NULL;
+
+  el->effects.gradient.enabled = 0;
+  el->effects.gradient.stops = NULL;
+  el->effects.gradient.angle = 90.0f;
+  el->effects.outline.enabled = 0;
+  el->effects.outline.width = 1;
+  el->effects.outline.color = SX_COLOR_BLACK;
+  el->effects.outline.alpha = 255;
+  el->effects.rounded.enabled = 0;
+  el->effects.rounded.radius = 0;
+  engine.last_created = el;
+}
+
+void _add_to_parent(UIElement *p, UIElement *c) {
+  if (p) {
+    c->parent = p;
+    list_add(p->children, c);
+    _layout_invalidate(p, list_length(p->children) - 1);
+  } else {
+    list_add(engine.root, c);
+    _hit_invalidate(NULL);
+  }
+}
+
+void sxui_init(const char *title, int w, int h, Uint32 seed) {
+  SDL_Init(SDL_INIT_VIDEO);
+  TTF_Init();
+
+  engine.window =
+      SDL_CreateWindow(title, SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+                       w, h, SDL_WINDOW_SHOWN | SDL_WINDOW_ALLOW_HIGHDPI);
+  engine.window_width = w;
+  engine.window_height = h;
+
+  if (engine.window == NULL) {
+    // Handle error, e.g., print to stderr and exit
+  }
+  engine.renderer = SDL_CreateRenderer(
+      engine.window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+  SDL_EventState(SDL_DROPFILE, SDL_ENABLE);
+  main_thread_id = SDL_ThreadID();
+  _posts_init();
+  SDL_AddEventWatch(_resize_watch, NULL);
+
+  engine.default_font = TTF_OpenFont("fonts/Montserrat-Regular.ttf", 16);
+  if (!engine.default_font) {
+    printf("Warning: Could not load fallback font Montserrat.\n");
+  }
+  engine.custom_font = NULL;
+
+  engine.root = list_new();
+  engine.theme = sx_generate_palette(seed, THEME_DARK);
+  engine.running = 1;
+  engine.focused = NULL;
+  engine.dragging_el = NULL;
+  engine.page_manager.pages = NULL;
+  engine.page_manager.current_page = -1;
+  engine.page_manager.initialized = 0;
+  engine.file_drop_callback = NULL;
+}
+
+int sxui_load_font(const char *path, int size) {
+  if (engine.custom_font) {
+    _glyph_cache_drop(engine.custom_font);
+    TTF_CloseFont(engine.custom_font);
+  }
+  engine.custom_font = TTF_OpenFont(path, size);
+  _text_size_font_changed();
+  return (engine.custom_font != NULL);
+>>>>>>> 410878f (feat: Add new pages and enhance input handling)
+}
+
+void sxui_set_theme(Uint32 seed, UIThemeMode mode) {
+    engine.theme = sx_generate_palette(seed, mode);
+}
+
+void _delete_element_recursive(UIElement* el);
+static void _canvas_mark_dirty(UICanvas* c, int x1, int y1, int x2, int y2);
+static void _canvas_damage(UICanvas* c, int x1, int y1, int x2, int y2);
+static void _canvas_acquire_front(UICanvas* c);
+static void _history_touch(UICanvasHistory* h, int x1, int y1, int x2, int y2);
+static void _canvas_composite(UICanvas* c, const SDL_Rect* r);
+static void _canvas_resize_layers(UICanvas* c);
+static void _canvas_free_layers(UICanvas* c);
+static void _tiled_render(UICanvas* c, int wx, int wy, Uint8 alpha);
+static void _tiled_free(UICanvas* c);
+static UIElement* _tiled_clone(UICanvas* src);
+static void _mapped_render(UICanvas* c, int wx, int wy, Uint8 alpha);
+static void _mapped_touch(CanvasMapping* m, int y1, int y2);
+static void _mapped_resize(UICanvas* c);
+static void _mapped_close(UICanvas* c);
+static void _particles_render(UIParticles* p, int wx, int wy, Uint8 alpha);
+static void _particles_free(UIParticles* p);
+static UIElement* _particles_clone(UIParticles* src);
+
+void sxui_cleanup(void) {
+    if (engine.root) {
+        for (size_t i = 0; i < list_length(engine.root); i++) {
+            UIElement* el = list_get(engine.root, i);
+            _delete_element_recursive(el);
+        }
+        list_free(engine.root);
+    }
+    
+    if (engine.page_manager.pages) {
+        list_free(engine.page_manager.pages);
+    }
+    
+    if (engine.default_font) {
+        TTF_CloseFont(engine.default_font);
+        engine.default_font = NULL;
+    }
+    if (engine.custom_font) {
+        TTF_CloseFont(engine.custom_font);
+        engine.custom_font = NULL;
+    }
+    sxui_sprite_cache_clear();
+    sxui_glyph_cache_clear();
+    free(flex_slots);
+    flex_slots = NULL;
+    flex_slot_cap = 0;
+    free(constraint_slots);
+    constraint_slots = NULL;
+    constraint_slot_cap = 0;
+    _hit_index_release(&root_hits);
+    memset(&root_hits, 0, sizeof(root_hits));
+    root_hits.dirty = 1;
+    free(hit_slots);
+    hit_slots = NULL;
+    hit_slot_cap = 0;
+    hover_count = 0;
+    sxui_record_end();
+    _replay_stop();
+    sxui_reset_latency();
+    free(event_queue);
+    event_queue = NULL;
+    event_count = event_cap = 0;
+    free(pending_deletes);
+    pending_deletes = NULL;
+    pending_delete_count = pending_delete_cap = 0;
+    free(handler_slots);
+    handler_slots = NULL;
+    handler_slot_count = handler_slot_cap = 0;
+    handler_free = -1;
+    if (dirty_frames) list_free(dirty_frames);
+    dirty_frames = NULL;
+    if (constrained) list_free(constrained);
+    constrained = NULL;
+    constraints_dirty = 0;
+    if (scrolling_frames) list_free(scrolling_frames);
+    scrolling_frames = NULL;
+    if (virtual_lists) list_free(virtual_lists);
+    virtual_lists = NULL;
+    SDL_DelEventWatch(_resize_watch, NULL);
+    SDL_DestroyRenderer(engine.renderer);
+    SDL_DestroyWindow(engine.window);
+    TTF_Quit();
+    SDL_Quit();
+}
+
+int sxui_should_quit(void) {
+    return !engine.running;
+}
+
+void sxui_poll_events(void) {
+    _session_frame();
+    _posts_drain();
+<<<<<<< HEAD
+    // Hit testing below needs positions from any pending layout.
+    sxui_layout_flush();
+    event_batching = 1;
+    SDL_Event e;
+    int mx, my;
+    _mouse_state(&mx, &my);
+
+    while (_poll_event(&e)) {
+        if (e.type == SDL_QUIT) {
+            engine.running = 0;
+        }
+
+        // Motion only moves the position; hover is resolved once after the
+        // batch, so a burst of motion events costs a single hit test.
+        if (e.type == SDL_MOUSEMOTION) {
+            mx = e.motion.x;
+            my = e.motion.y;
+            hover_outside = 0;
+        }
+        if (e.type == SDL_WINDOWEVENT) {
+            if (e.window.event == SDL_WINDOWEVENT_LEAVE) hover_outside = 1;
+            if (e.window.event == SDL_WINDOWEVENT_ENTER) hover_outside = 0;
+        }
+        
+        if (e.type == SDL_DROPFILE) {
+            char* dropped_file = e.drop.file;
+            UIElement* hit = _hit_test(mx, my);
+            
+            if (engine.file_drop_callback) {
+                QueuedEvent* ev = _event_push(EVENT_FILE_DROP, hit, 0, 0);
+                if (ev) {
+                    ev->file = dropped_file;
+                    dropped_file = NULL;
+                } else {
+                    engine.file_drop_callback(hit, dropped_file);
+                }
+=======
+  // Hit testing below needs positions from any pending layout.
+  sxui_layout_flush();
+  event_batching = 1;
+  SDL_Event e;
+  int mx, my;
+  _mouse_state(&mx, &my);
+  engine.mouse_x = mx;
+  engine.mouse_y = my;
+
+  // Sync previous states
+  memcpy(engine.last_mouse_buttons, engine.mouse_buttons,
+         sizeof(engine.mouse_buttons));
+  memcpy(engine.last_keyboard_state, engine.keyboard_state,
+         sizeof(engine.keyboard_state));
+
+  while (_poll_event(&e)) {
+    if (e.type == SDL_QUIT) {
+      engine.running = 0;
+    }
+
+    // Motion only moves the position; hover is resolved once after the
+    // batch, so a burst of motion events costs a single hit test.
+    if (e.type == SDL_MOUSEMOTION) {
+      mx = engine.mouse_x = e.motion.x;
+      my = engine.mouse_y = e.motion.y;
+      hover_outside = 0;
+    }
+
+    if (e.type == SDL_WINDOWEVENT) {
+      if (e.window.event == SDL_WINDOWEVENT_RESIZED) {
+        engine.window_width = e.window.data1;
+        engine.window_height = e.window.data2;
+      }
+      if (e.window.event == SDL_WINDOWEVENT_LEAVE)
+        hover_outside = 1;
+      if (e.window.event == SDL_WINDOWEVENT_ENTER)
+        hover_outside = 0;
+    }
+
+    if (e.type == SDL_KEYDOWN) {
+      if (e.key.keysym.scancode < 512) {
+        engine.keyboard_state[e.key.keysym.scancode] = 1;
+      }
+    }
+    if (e.type == SDL_KEYUP) {
+      if (e.key.keysym.scancode < 512) {
+        engine.keyboard_state[e.key.keysym.scancode] = 0;
+      }
+    }
+
+    if (e.type == SDL_DROPFILE) {
+      char *dropped_file = e.drop.file;
+      UIElement *hit = _hit_test(mx, my);
+
+      if (engine.file_drop_callback) {
+        QueuedEvent *ev = _event_push(EVENT_FILE_DROP, hit, 0, 0);
+        if (ev) {
+          ev->file = dropped_file;
+          dropped_file = NULL;
+        } else {
+          engine.file_drop_callback(hit, dropped_file);
+        }
+      }
+
+      SDL_free(dropped_file);
+    }
+
+    if (e.type == SDL_MOUSEBUTTONDOWN) {
+      int btn_idx =
+          e.button.button -
+          1; // Internal indexing: 0 for left, 1 for middle, 2 for right
+      if (btn_idx >= 0 && btn_idx < 8) {
+        engine.mouse_buttons[btn_idx] = 1;
+      }
+
+      UIElement *hit = _hit_test(mx, my);
+
+      engine.mouse_pressed_element = hit;
+      engine.mouse_pressed_button = e.button.button;
+
+      if (engine.focused && engine.focused != hit) {
+        if (engine.focused->type == UI_INPUT) {
+          trigger_focus((UITextInput *)engine.focused, 0);
+          SDL_StopTextInput();
+        }
+        if (engine.focused->type == UI_DROPDOWN) {
+          ((UIDropdown *)engine.focused)->is_open = 0;
+        }
+        engine.focused = NULL;
+      }
+
+      if (hit) {
+        if (hit->flags & UI_FLAG_DRAGGABLE) {
+          engine.dragging_el = hit;
+          engine.drag_off_x = mx - hit->x;
+          engine.drag_off_y = my - hit->y;
+        }
+
+        if (hit->type == UI_BUTTON) {
+          UIButton *b = (UIButton *)hit;
+          b->_pressed = 1;
+          b->_lastClickTime = _clock_ticks();
+          trigger_click(b);
+        } else if (hit->type == UI_CHECKBOX) {
+          UICheckBox *cb = (UICheckBox *)hit;
+          cb->value = !cb->value;
+          trigger_value_changed(cb, (float)cb->value);
+        } else if (hit->type == UI_SLIDER) {
+          engine.focused = hit;
+        } else if (hit->type == UI_DROPDOWN) {
+          UIDropdown *dd = (UIDropdown *)hit;
+          int wx, wy;
+          sxui_get_abs_pos(hit, &wx, &wy);
+          int header_h = 30;
+
+          if (my < wy + header_h) {
+            dd->is_open = !dd->is_open;
+            engine.focused = (UIElement *)dd;
+          } else if (dd->is_open) {
+            int item_idx = (my - (wy + header_h)) / 30;
+            if (item_idx >= 0 && item_idx < dd->option_count) {
+              dd->selected_index = item_idx;
+              dd->is_open = 0;
+              trigger_dropdown_changed(dd, item_idx, dd->options[item_idx]);
+>>>>>>> 410878f (feat: Add new pages and enhance input handling)
+            }
+            
+            SDL_free(dropped_file);
+        }
+
+        if (e.type == SDL_MOUSEBUTTONDOWN) {
+            UIElement* hit = _hit_test(mx, my);
+            int clicked_ui = (hit != NULL);
 
             if (engine.focused && engine.focused != hit) {
                 if (engine.focused->type == UI_INPUT) {
                     trigger_focus((UITextInput*)engine.focused, 0);
                     SDL_StopTextInput();
                 }
-                if (engine.focused->type == UI_DROPDOWN) {
-                    ((UIDropdown*)engine.focused)->is_open = 0;
+                if (engine.focused->type == UI_DROPDOWN) {
+                    ((UIDropdown*)engine.focused)->is_open = 0;
+                }
+                engine.focused = NULL;
+            }
+            
+            if (hit) {
+                if (hit->flags & UI_FLAG_DRAGGABLE) {
+                    engine.dragging_el = hit;
+                    engine.drag_off_x = mx - hit->x;
+                    engine.drag_off_y = my - hit->y;
+                }
+                
+                if (hit->type == UI_BUTTON) {
+                    UIButton* b = (UIButton*)hit;
+                    b->_pressed = 1;
+                    b->_lastClickTime = _clock_ticks();
+                    trigger_click(b);
+                }
+                else if (hit->type == UI_CHECKBOX) {
+                    UICheckBox* cb = (UICheckBox*)hit;
+                    cb->value = !cb->value;
+                    trigger_value_changed(cb, (float)cb->value);
+                }
+                else if (hit->type == UI_SLIDER) {
+                    engine.focused = hit;
+                }
+                else if (hit->type == UI_DROPDOWN) {
+                    UIDropdown* dd = (UIDropdown*)hit;
+                    int header_h = 30;
+                    int wy = hit->y;
+                    UIElement* p = hit->parent;
+                    while (p) {
+                        wy += p->y;
+                        if (p->type == UI_FRAME) wy -= ((UIFrame*)p)->scroll_y;
+                        p = p->parent;
+                    }
+                    
+                    if (my < wy + header_h) {
+                        dd->is_open = !dd->is_open;
+                        engine.focused = (UIElement*)dd;
+                    } else if (dd->is_open) {
+                        int item_idx = (my - (wy + header_h)) / 30;
+                        if (item_idx >= 0 && item_idx < dd->option_count) {
+                            dd->selected_index = item_idx;
+                            dd->is_open = 0;
+                            trigger_dropdown_changed(dd, item_idx, dd->options[item_idx]);
+                        }
+                    }
+                }
+                else if (hit->type == UI_INPUT) {
+                    UITextInput* ti = (UITextInput*)hit;
+                    if (engine.focused != (UIElement*)ti) {
+                        if (engine.focused && engine.focused->type == UI_INPUT) {
+                            trigger_focus((UITextInput*)engine.focused, 0);
+                        }
+                        engine.focused = (UIElement*)ti;
+                        trigger_focus(ti, 1);
+                        SDL_StartTextInput();
+                    }
+                    ti->cursorPosition = ti->len;
+                    ti->selectionAnchor = ti->len;
+                }
+            }
+            
+            if (!clicked_ui && engine.focused) {
+                if (engine.focused->type == UI_INPUT) {
+                    trigger_focus((UITextInput*)engine.focused, 0);
+                    SDL_StopTextInput();
+                }
+                if (engine.focused->type == UI_DROPDOWN) {
+                    ((UIDropdown*)engine.focused)->is_open = 0;
+                }
+                engine.focused = NULL;
+            }
+        }
+<<<<<<< HEAD
+        
+        if (e.type == SDL_MOUSEBUTTONUP) {
+            if (engine.dragging_el) {
+                engine.dragging_el = NULL;
+            }
+            if (engine.focused && engine.focused->type == UI_SLIDER) {
+                engine.focused = NULL;
+            }
+=======
+      }
+
+      if (!hit && engine.focused) { // Clicked outside focused element
+        if (engine.focused->type == UI_INPUT) {
+          trigger_focus((UITextInput *)engine.focused, 0);
+          SDL_StopTextInput();
+>>>>>>> 410878f (feat: Add new pages and enhance input handling)
+        }
+        
+        if (e.type == SDL_MOUSEWHEEL) {
+            UIElement* hit = _hit_test(mx, my);
+            while (hit) {
+                if (hit->type == UI_FRAME && (hit->flags & (UI_SCROLLABLE | UI_SCROLLABLE_X))) {
+                    _scroll_wheel((UIFrame*)hit, e.wheel.x, e.wheel.y);
+                    break;
+                }
+                hit = hit->parent;
+            }
+        }
+
+<<<<<<< HEAD
+        if (engine.focused && engine.focused->type == UI_INPUT) {
+            if (e.type == SDL_TEXTINPUT || e.type == SDL_KEYDOWN) {
+                read_input((UITextInput*)engine.focused, &e);
+            }
+=======
+    if (e.type == SDL_MOUSEBUTTONUP) {
+      int btn_idx = e.button.button - 1;
+      if (btn_idx >= 0 && btn_idx < 8) {
+        engine.mouse_buttons[btn_idx] = 0;
+      }
+
+      UIElement *hit = _hit_test(mx, my);
+      if (hit == engine.mouse_pressed_element &&
+          e.button.button == engine.mouse_pressed_button &&
+          engine.dragging_el == NULL) {
+        trigger_mouse_click(hit, e.button.button);
+      }
+      engine.mouse_pressed_element = NULL;
+      engine.mouse_pressed_button = 0;
+
+      if (engine.dragging_el) {
+        engine.dragging_el = NULL;
+      }
+      if (engine.focused && engine.focused->type == UI_SLIDER) {
+        engine.focused = NULL;
+      }
+    }
+
+    if (e.type == SDL_MOUSEWHEEL) {
+      UIElement *hit = _hit_test(mx, my);
+      while (hit) {
+        if (hit->type == UI_FRAME &&
+            (hit->flags & (UI_SCROLLABLE | UI_SCROLLABLE_X))) {
+          _scroll_wheel((UIFrame *)hit, e.wheel.x, e.wheel.y);
+          break;
+>>>>>>> 410878f (feat: Add new pages and enhance input handling)
+        }
+    }
+
+    if (engine.dragging_el) {
+        engine.dragging_el->x = mx - engine.drag_off_x;
+        engine.dragging_el->y = my - engine.drag_off_y;
+        _hit_invalidate(engine.dragging_el->parent);
+    }
+
+<<<<<<< HEAD
+    if (_mouse_state(NULL, NULL) & SDL_BUTTON(SDL_BUTTON_LEFT)) {
+        if (engine.focused && engine.focused->type == UI_SLIDER) {
+            UISlider* s = (UISlider*)engine.focused;
+            int wx = s->el.x;
+            UIElement* p = s->el.parent;
+            while (p) {
+                wx += p->x;
+                if (p->type == UI_FRAME) {
+                    wx -= ((UIFrame*)p)->scroll_x;
                 }
-                engine.focused = NULL;
+                p = p->parent;
+            }
+            float old_val = s->value;
+            s->value = (float)(mx - wx) / s->el.w;
+            if (s->value < 0) s->value = 0;
+            if (s->value > 1) s->value = 1;
+            if (fabs(s->value - old_val) > 0.001f) {
+                trigger_value_changed(s, s->value);
+            }
+=======
+  if (engine.dragging_el) {
+    engine.dragging_el->x = mx - engine.drag_off_x;
+    engine.dragging_el->y = my - engine.drag_off_y;
+    _hit_invalidate(engine.dragging_el->parent);
+  }
+
+  if (sxui_is_mouse_button_down(SDL_BUTTON_LEFT)) { // Use new public function
+    if (engine.focused && engine.focused->type == UI_SLIDER) {
+      UISlider *s = (UISlider *)engine.focused;
+      int wx = s->el.x;
+      UIElement *p = s->el.parent;
+      while (p) {
+        wx += p->x;
+        if (p->type == UI_FRAME) {
+          wx -= ((UIFrame *)p)->scroll_x;
+>>>>>>> 410878f (feat: Add new pages and enhance input handling)
+        }
+    }
+
+    _hover_update(mx, my);
+    _events_dispatch();
+    _posts_drain();
+
+    // Low-latency mode presents the input's effect now instead of after the
+    // app's update. The app's own sxui_render still runs, so frames with
+    // input are drawn twice.
+    if (latency_low && latency_pending_count) sxui_render();
+}
+
+UIElement* sxui_frame(UIElement* p, int x, int y, int w, int h, int flags) {
+    UIFrame* f = calloc(1, sizeof(UIFrame));
+    init_base(&f->el, x, y, w, h, UI_FRAME);
+    f->el.flags = flags;
+    f->padding = 10;
+    f->spacing = 8;
+    f->scroll_bar_width = 6;
+    _add_to_parent(p, (UIElement*)f);
+    return (UIElement*)f;
+}
+
+UIElement* sxui_button(UIElement* p, const char* label, ClickCallback cb) {
+    UIButton* b = calloc(1, sizeof(UIButton));
+    init_base(&b->el, 0, 0, 0, 0, UI_BUTTON);
+    b->text = strdup(label);
+    if (cb) bind_event(&b->onClick, cb);
+    _add_to_parent(p, (UIElement*)b);
+    return (UIElement*)b;
+}
+
+UIElement* sxui_label(UIElement* p, const char* text) {
+    UILabel* l = calloc(1, sizeof(UILabel));
+    init_base(&l->el, 0, 0, 0, 0, UI_LABEL);
+    l->text = strdup(text);
+    _add_to_parent(p, (UIElement*)l);
+    return (UIElement*)l;
+}
+
+UIElement* sxui_input(UIElement* p, const char* placeholder, int is_pass) {
+    UITextInput* i = calloc(1, sizeof(UITextInput));
+    init_base(&i->el, 0, 0, 0, 0, UI_INPUT);
+    if (is_pass) i->el.flags |= UI_FLAG_PASSWORD;
+    strncpy(i->placeholder, placeholder, INPUT_MAX - 1);
+    _add_to_parent(p, (UIElement*)i);
+    return (UIElement*)i;
+}
+
+UIElement* sxui_checkbox(UIElement* p, const char* label) {
+    UICheckBox* c = calloc(1, sizeof(UICheckBox));
+    init_base(&c->el, 0, 0, 0, 0, UI_CHECKBOX);
+    c->text = strdup(label);
+    _add_to_parent(p, (UIElement*)c);
+    return (UIElement*)c;
+}
+
+UIElement* sxui_slider(UIElement* p, float initial) {
+    UISlider* s = calloc(1, sizeof(UISlider));
+    init_base(&s->el, 0, 0, 0, 0, UI_SLIDER);
+    s->value = initial;
+    _add_to_parent(p, (UIElement*)s);
+    return (UIElement*)s;
+}
+
+<<<<<<< HEAD
+UIElement* sxui_dropdown(UIElement* parent, const char** options, int option_count, int default_index) {
+    UIDropdown* dd = calloc(1, sizeof(UIDropdown));
+    init_base(&dd->el, 0, 0, 0, 0, UI_DROPDOWN);
+    
+    dd->option_count = option_count;
+    dd->options = malloc(sizeof(char*) * option_count);
+    for (int i = 0; i < option_count; i++) {
+        dd->options[i] = strdup(options[i]);
+=======
+UIElement *sxui_dropdown(UIElement *parent, const char **options,
+                         int option_count, int default_index) {
+  UIDropdown *dd = calloc(1, sizeof(UIDropdown));
+  init_base(&dd->el, 0, 0, 0, 0, UI_DROPDOWN);
+
+  dd->option_count = option_count;
+  dd->options = malloc(sizeof(char *) * option_count);
+  for (int i = 0; i < option_count; i++) {
+    dd->options[i] = strdup(options[i]);
+  }
+  dd->selected_index =
+      (default_index >= 0 && default_index < option_count) ? default_index : 0;
+  dd->is_open = 0;
+  dd->el.z_index = DROPDOWN_Z_INDEX;
+
+  _add_to_parent(parent, (UIElement *)dd);
+  return (UIElement *)dd;
+}
+
+UIElement *sxui_canvas(UIElement *parent, int x, int y, int w, int h) {
+  UICanvas *c = calloc(1, sizeof(UICanvas));
+  init_base(&c->el, x, y, w, h, UI_CANVAS);
+
+  c->texture = SDL_CreateTexture(engine.renderer, SDL_PIXELFORMAT_RGBA8888,
+                                 SDL_TEXTUREACCESS_STREAMING, w, h);
+  c->pixels = calloc(w * h, sizeof(Uint32));
+  c->pitch = w * sizeof(Uint32);
+  _canvas_mark_dirty(c, 0, 0, w, h);
+
+  _add_to_parent(parent, (UIElement *)c);
+  return (UIElement *)c;
+}
+
+void _delete_element_recursive(UIElement *el) {
+  if (!el)
+    return;
+
+  for (size_t i = 0; i < list_length(el->children); i++) {
+    _delete_element_recursive(list_get(el->children, i));
+  }
+
+  list_free(el->children);
+  if (el == engine.mouse_pressed_element)
+    engine.mouse_pressed_element = NULL;
+  _handlers_free(el->onMouseEnter);
+  _handlers_free(el->onMouseLeave);
+  _handlers_free(el->onMouseClick);
+  _flex_free(el);
+  _constraint_free(el);
+  _text_size_free(el);
+  _hit_index_free(el);
+  _hover_forget(el);
+
+  if (el->effects.gradient.stops) {
+    for (size_t i = 0; i < list_length(el->effects.gradient.stops); i++) {
+      free(list_get(el->effects.gradient.stops, i));
+>>>>>>> 410878f (feat: Add new pages and enhance input handling)
+    }
+    dd->selected_index = (default_index >= 0 && default_index < option_count) ? default_index : 0;
+    dd->is_open = 0;
+    dd->el.z_index = DROPDOWN_Z_INDEX;
+    
+    _add_to_parent(parent, (UIElement*)dd);
+    return (UIElement*)dd;
+}
+
+UIElement* sxui_canvas(UIElement* parent, int x, int y, int w, int h) {
+    UICanvas* c = calloc(1, sizeof(UICanvas));
+    init_base(&c->el, x, y, w, h, UI_CANVAS);
+    
+    c->texture = SDL_CreateTexture(engine.renderer, SDL_PIXELFORMAT_RGBA8888,
+                                    SDL_TEXTUREACCESS_STREAMING, w, h);
+    c->pixels = calloc(w * h, sizeof(Uint32));
+    c->pitch = w * sizeof(Uint32);
+    // Damage-rect uploads never touch undrawn pixels, so the fresh texture
+    // starts fully dirty.
+    _canvas_mark_dirty(c, 0, 0, w, h);
+    
+    _add_to_parent(parent, (UIElement*)c);
+    return (UIElement*)c;
+}
+
+<<<<<<< HEAD
+void _delete_element_recursive(UIElement* el) {
+    if (!el) return;
+    
+=======
+void sxui_delete(UIElement *element) {
+  if (!element)
+    return;
+  if (_delete_defer(element))
+    return;
+
+  if (element == engine.focused) {
+    engine.focused = NULL;
+  }
+  if (element == engine.dragging_el) {
+    engine.dragging_el = NULL;
+  }
+
+  if (element->parent) {
+    list_remove(element->parent->children, element);
+    _layout_invalidate(element->parent, 0);
+  } else {
+    list_remove(engine.root, element);
+    _hit_invalidate(NULL);
+  }
+
+  _delete_element_recursive(element);
+}
+
+void sxui_set_position(UIElement *el, int x, int y) {
+  if (el) {
+    el->x = x;
+    el->y = y;
+    _hit_invalidate(el->parent);
+  }
+}
+
+void sxui_set_size(UIElement *el, int w, int h) {
+  if (el) {
+    el->w = w;
+    el->h = h;
+    _layout_resized(el);
+
+    if (el->type == UI_CANVAS && ((UICanvas *)el)->mapped) {
+      _mapped_resize((UICanvas *)el);
+    } else if (el->type == UI_CANVAS && !((UICanvas *)el)->tiles) {
+      UICanvas *c = (UICanvas *)el;
+      int double_buffered = c->buffers[0] != NULL;
+      sxui_canvas_set_double_buffered(el, 0);
+      if (c->texture)
+        SDL_DestroyTexture(c->texture);
+      if (c->pixels)
+        free(c->pixels);
+
+      c->texture = SDL_CreateTexture(engine.renderer, SDL_PIXELFORMAT_RGBA8888,
+                                     SDL_TEXTUREACCESS_STREAMING, w, h);
+      c->pixels = calloc(w * h, sizeof(Uint32));
+      c->pitch = w * sizeof(Uint32);
+      c->dirty = 0;
+      _canvas_mark_dirty(c, 0, 0, w, h);
+      _canvas_resize_layers(c);
+      if (double_buffered)
+        sxui_canvas_set_double_buffered(el, 1);
+    }
+  }
+}
+
+static void sxui_get_abs_pos(UIElement *el, int *x, int *y) {
+  if (!el)
+    return;
+  int wx = el->x;
+  int wy = el->y;
+  UIElement *p = el->parent;
+  while (p) {
+    wx += p->x;
+    wy += p->y;
+    if (p->type == UI_FRAME) {
+      wx -= ((UIFrame *)p)->scroll_x;
+      wy -= ((UIFrame *)p)->scroll_y;
+    }
+    p = p->parent;
+  }
+  if (x)
+    *x = wx;
+  if (y)
+    *y = wy;
+}
+
+// --- Utility Getters ---
+
+int sxui_get_width(UIElement *el) { return el ? el->w : 0; }
+int sxui_get_height(UIElement *el) { return el ? el->h : 0; }
+
+void sxui_get_mouse_pos(int *x, int *y) {
+  if (x)
+    *x = engine.mouse_x;
+  if (y)
+    *y = engine.mouse_y;
+}
+
+int sxui_get_mouse_x(void) { return engine.mouse_x; }
+int sxui_get_mouse_y(void) { return engine.mouse_y; }
+
+int sxui_is_mouse_button_down(int button) {
+  // SDL_BUTTON_LEFT is 1, SDL_BUTTON_RIGHT is 3, etc.
+  // Our internal array is 0-indexed.
+  int btn_idx = button - 1;
+  if (btn_idx >= 0 && btn_idx < 8)
+    return engine.mouse_buttons[btn_idx];
+  return 0;
+}
+
+int sxui_is_mouse_button_up(int button) {
+  // SDL_BUTTON_LEFT is 1, SDL_BUTTON_RIGHT is 3, etc.
+  // Our internal array is 0-indexed.
+  int btn_idx = button - 1;
+  if (btn_idx >= 0 && btn_idx < 8)
+    return !engine.mouse_buttons[btn_idx];
+  return 0;
+}
+
+int sxui_is_mouse_button_pressed(int button) {
+  // SDL_BUTTON_LEFT is 1, SDL_BUTTON_RIGHT is 3, etc.
+  // Our internal array is 0-indexed.
+  int btn_idx = button - 1;
+  if (btn_idx >= 0 && btn_idx < 8)
+    return engine.mouse_buttons[btn_idx] && !engine.last_mouse_buttons[btn_idx];
+  return 0;
+}
+
+int sxui_is_mouse_button_released(int button) {
+  // SDL_BUTTON_LEFT is 1, SDL_BUTTON_RIGHT is 3, etc.
+  // Our internal array is 0-indexed.
+  int btn_idx = button - 1;
+  if (btn_idx >= 0 && btn_idx < 8)
+    return !engine.mouse_buttons[btn_idx] && engine.last_mouse_buttons[btn_idx];
+  return 0;
+}
+
+int sxui_is_key_down(int scancode) {
+  if (scancode >= 0 && scancode < 512)
+    return engine.keyboard_state[scancode];
+  return 0;
+}
+
+int sxui_is_key_pressed(int scancode) {
+  if (scancode >= 0 && scancode < 512)
+    return engine.keyboard_state[scancode] &&
+           !engine.last_keyboard_state[scancode];
+  return 0;
+}
+
+int sxui_is_key_released(int scancode) {
+  if (scancode >= 0 && scancode < 512)
+    return !engine.keyboard_state[scancode] &&
+           engine.last_keyboard_state[scancode];
+  return 0;
+}
+
+void sxui_get_window_size(int *w, int *h) {
+  if (w)
+    *w = engine.window_width;
+  if (h)
+    *h = engine.window_height;
+}
+
+int sxui_get_window_width(void) { return engine.window_width; }
+int sxui_get_window_height(void) { return engine.window_height; }
+
+void sxui_quit(void) { engine.running = 0; }
+
+// --- Event Binding ---
+
+UIConnection sxui_on_mouse_click(UIElement *el, MouseClickCallback cb) {
+  if (el && cb)
+    return bind_event(&el->onMouseClick, cb);
+  UIConnection empty = {0, 0};
+  return empty;
+}
+
+const char *sxui_get_scancode_name(int scancode) {
+  return SDL_GetScancodeName((SDL_Scancode)scancode);
+}
+
+// --- Element Properties ---
+
+void sxui_set_visible(UIElement *el, int visible) {
+  if (el) {
+    if (!(el->flags & UI_FLAG_HIDDEN) != !!visible)
+      _layout_invalidate(el->parent, 0);
+    if (visible)
+      el->flags &= ~UI_FLAG_HIDDEN;
+    else
+      el->flags |= UI_FLAG_HIDDEN;
+
+>>>>>>> 410878f (feat: Add new pages and enhance input handling)
+    for (size_t i = 0; i < list_length(el->children); i++) {
+        _delete_element_recursive(list_get(el->children, i));
+    }
+    
+    list_free(el->children);
+    _handlers_free(el->onMouseEnter);
+    _handlers_free(el->onMouseLeave);
+    _flex_free(el);
+    _constraint_free(el);
+    _text_size_free(el);
+    _hit_index_free(el);
+    _hover_forget(el);
+    
+    if (el->effects.gradient.stops) {
+        for (size_t i = 0; i < list_length(el->effects.gradient.stops); i++) {
+            free(list_get(el->effects.gradient.stops, i));
+        }
+        list_free(el->effects.gradient.stops);
+    }
+    
+    switch (el->type) {
+        case UI_FRAME:
+            if (((UIFrame*)el)->layout_dirty) list_remove(dirty_frames, el);
+            if (((UIFrame*)el)->virt) _vlist_free((UIFrame*)el);
+            _scroll_stop((UIFrame*)el);
+            break;
+        case UI_BUTTON:
+            free(((UIButton*)el)->text);
+            _handlers_free(((UIButton*)el)->onClick);
+            break;
+        case UI_LABEL:
+            free(((UILabel*)el)->text);
+            break;
+        case UI_INPUT:
+            _handlers_free(((UITextInput*)el)->onFocusChanged);
+            _handlers_free(((UITextInput*)el)->onTextChanged);
+            _handlers_free(((UITextInput*)el)->onSubmit);
+            break;
+        case UI_CHECKBOX:
+            free(((UICheckBox*)el)->text);
+            _handlers_free(((UICheckBox*)el)->onValueChanged);
+            break;
+        case UI_SLIDER:
+            _handlers_free(((UISlider*)el)->onValueChanged);
+            break;
+        case UI_DROPDOWN:
+            for (int i = 0; i < ((UIDropdown*)el)->option_count; i++) {
+                free(((UIDropdown*)el)->options[i]);
+            }
+            free(((UIDropdown*)el)->options);
+            _handlers_free(((UIDropdown*)el)->onSelectionChanged);
+            break;
+        case UI_CANVAS:
+            sxui_canvas_set_double_buffered(el, 0);
+            sxui_canvas_set_history(el, 0);
+            _canvas_free_layers((UICanvas*)el);
+            _tiled_free((UICanvas*)el);
+            _mapped_close((UICanvas*)el);
+            if (((UICanvas*)el)->texture) {
+                SDL_DestroyTexture(((UICanvas*)el)->texture);
+            }
+            free(((UICanvas*)el)->pixels);
+            break;
+        case UI_PARTICLES:
+            _particles_free((UIParticles*)el);
+            break;
+        default:
+            break;
+    }
+    
+    free(el);
+}
+
+UIElement* sxui_clone(UIElement* element) {
+    if (!element) return NULL;
+    
+    UIElement* clone = NULL;
+    
+    switch (element->type) {
+        case UI_BUTTON: {
+            UIButton* src = (UIButton*)element;
+            clone = sxui_button(NULL, src->text, NULL);
+            break;
+        }
+        case UI_LABEL: {
+            UILabel* src = (UILabel*)element;
+            clone = sxui_label(NULL, src->text);
+            break;
+        }
+        case UI_INPUT: {
+            UITextInput* src = (UITextInput*)element;
+            clone = sxui_input(NULL, src->placeholder, (element->flags & UI_FLAG_PASSWORD));
+            sxui_set_text(clone, src->text);
+            break;
+        }
+        case UI_CHECKBOX: {
+            UICheckBox* src = (UICheckBox*)element;
+            clone = sxui_checkbox(NULL, src->text);
+            ((UICheckBox*)clone)->value = src->value;
+            break;
+        }
+        case UI_SLIDER: {
+            UISlider* src = (UISlider*)element;
+            clone = sxui_slider(NULL, src->value);
+            break;
+        }
+        case UI_DROPDOWN: {
+            UIDropdown* src = (UIDropdown*)element;
+            clone = sxui_dropdown(NULL, (const char**)src->options, src->option_count, src->selected_index);
+            break;
+        }
+        case UI_FRAME: {
+            clone = sxui_frame(NULL, element->x, element->y, element->w, element->h, element->flags);
+            UIFrame* src = (UIFrame*)element;
+            UIFrame* dst = (UIFrame*)clone;
+            dst->padding = src->padding;
+            dst->spacing = src->spacing;
+            dst->max_grid_cols = src->max_grid_cols;
+            dst->justify = src->justify;
+            dst->align = src->align;
+            break;
+        }
+        case UI_CANVAS: {
+            UICanvas* src = (UICanvas*)element;
+            if (src->tiles) {
+                clone = _tiled_clone(src);
+                break;
+            }
+            clone = sxui_canvas(NULL, element->x, element->y, element->w, element->h);
+            UICanvas* dst = (UICanvas*)clone;
+            const Uint32* pixels = src->pixels;
+            if (src->layers) {
+                SDL_Rect all = {0, 0, element->w, element->h};
+                _canvas_composite(src, &all);
+                pixels = src->composite;
+            }
+            memcpy(dst->pixels, pixels, element->w * element->h * sizeof(Uint32));
+            dst->ring = src->ring;
+            dst->ring_head = src->ring_head;
+            _canvas_mark_dirty(dst, 0, 0, element->w, element->h);
+            break;
+        }
+        case UI_PARTICLES:
+            clone = _particles_clone((UIParticles*)element);
+            break;
+    }
+    
+    if (clone) {
+        clone->x = element->x;
+        clone->y = element->y;
+        clone->w = element->w;
+        clone->h = element->h;
+        clone->flags = element->flags;
+        clone->z_index = element->z_index;
+        clone->transparency = element->transparency;
+        clone->custom_color = element->custom_color;
+        clone->has_custom_color = element->has_custom_color;
+        clone->effects = element->effects;
+        
+        if (element->effects.gradient.stops) {
+            clone->effects.gradient.stops = list_new();
+            for (size_t i = 0; i < list_length(element->effects.gradient.stops); i++) {
+                GradientStop* orig = list_get(element->effects.gradient.stops, i);
+                GradientStop* copy = malloc(sizeof(GradientStop));
+                *copy = *orig;
+                list_add(clone->effects.gradient.stops, copy);
             }
+        }
+        if (element->flex && (clone->flex = malloc(sizeof(UIFlexItem)))) {
+            *clone->flex = *element->flex;
+            clone->flex->cached = 0;
+        }
+        if (element->constraint && _constraint_get(clone)) {
+            *clone->constraint = *element->constraint;
+            clone->constraint->parent_w = -1;
+            constraints_dirty = 1;
+        }
+        if (element->text_size && _text_size_get(clone)) {
+            *clone->text_size = *element->text_size;
+            clone->text_size->valid = 0;
+        }
+    }
+    
+    return clone;
+}
+
+void sxui_delete(UIElement* element) {
+    if (!element) return;
+    if (_delete_defer(element)) return;
+    
+    if (element == engine.focused) {
+        engine.focused = NULL;
+    }
+    if (element == engine.dragging_el) {
+        engine.dragging_el = NULL;
+    }
+    
+    if (element->parent) {
+        list_remove(element->parent->children, element);
+        _layout_invalidate(element->parent, 0);
+    } else {
+        list_remove(engine.root, element);
+        _hit_invalidate(NULL);
+    }
+    
+    _delete_element_recursive(element);
+}
+
+void sxui_set_position(UIElement* el, int x, int y) {
+    if (el) {
+        el->x = x;
+        el->y = y;
+        _hit_invalidate(el->parent);
+    }
+}
+
+void sxui_set_size(UIElement* el, int w, int h) {
+    if (el) { 
+        el->w = w; 
+        el->h = h;
+        _layout_resized(el);
+        
+        // Tiled canvases keep their world; only the viewport changes size.
+        // Mapped canvases remap their file at the new size.
+        if (el->type == UI_CANVAS && ((UICanvas*)el)->mapped) {
+            _mapped_resize((UICanvas*)el);
+        } else if (el->type == UI_CANVAS && !((UICanvas*)el)->tiles) {
+            UICanvas* c = (UICanvas*)el;
+            int double_buffered = c->buffers[0] != NULL;
+            sxui_canvas_set_double_buffered(el, 0);
+            if (c->texture) SDL_DestroyTexture(c->texture);
+            if (c->pixels) free(c->pixels);
             
-            if (hit) {
-                if (hit->flags & UI_FLAG_DRAGGABLE) {
-                    engine.dragging_el = hit;
-                    engine.drag_off_x = mx - hit->x;
-                    engine.drag_off_y = my - hit->y;
-                }
-                
-                if (hit->type == UI_BUTTON) {
-                    UIButton* b = (UIButton*)hit;
-                    b->_pressed = 1;
-                    b->_lastClickTime = SDL_GetTicks();
-                    trigger_click(b);
-                }
-                else if (hit->type == UI_CHECKBOX) {
-                    UICheckBox* cb = (UICheckBox*)hit;
-                    cb->value = !cb->value;
-                    trigger_value_changed(cb, (float)cb->value);
-                }
-                else if (hit->type == UI_SLIDER) {
-                    engine.focused = hit;
-                }
-                else if (hit->type == UI_DROPDOWN) {
-                    UIDropdown* dd = (UIDropdown*)hit;
-                    int header_h = 30;
-                    int wy = hit->y;
-                    UIElement* p = hit->parent;
-                    while (p) {
-                        wy += p->y;
-                        if (p->type == UI_FRAME) wy -= ((UIFrame*)p)->scroll_y;
-                        p = p->parent;
-                    }
-                    
-                    if (my < wy + header_h) {
-                        dd->is_open = !dd->is_open;
-                        engine.focused = (UIElement*)dd;
-                    } else if (dd->is_open) {
-                        int item_idx = (my - (wy + header_h)) / 30;
-                        if (item_idx >= 0 && item_idx < dd->option_count) {
-                            dd->selected_index = item_idx;
-                            dd->is_open = 0;
-                            trigger_dropdown_changed(dd, item_idx, dd->options[item_idx]);
-                        }
-                    }
-                }
-                else if (hit->type == UI_INPUT) {
-                    UITextInput* ti = (UITextInput*)hit;
-                    if (engine.focused != (UIElement*)ti) {
-                        if (engine.focused && engine.focused->type == UI_INPUT) {
-                            trigger_focus((UITextInput*)engine.focused, 0);
-                        }
-                        engine.focused = (UIElement*)ti;
-                        trigger_focus(ti, 1);
-                        SDL_StartTextInput();
-                    }
-                    ti->cursorPosition = ti->len;
-                    ti->selectionAnchor = ti->len;
-                }
+            c->texture = SDL_CreateTexture(engine.renderer, SDL_PIXELFORMAT_RGBA8888,
+                                          SDL_TEXTUREACCESS_STREAMING, w, h);
+            c->pixels = calloc(w * h, sizeof(Uint32));
+            c->pitch = w * sizeof(Uint32);
+            c->dirty = 0;
+            _canvas_mark_dirty(c, 0, 0, w, h);
+            _canvas_resize_layers(c);
+            if (double_buffered) sxui_canvas_set_double_buffered(el, 1);
+        }
+    }
+}
+
+void sxui_set_visible(UIElement* el, int visible) {
+    if (el) {
+        if (!(el->flags & UI_FLAG_HIDDEN) != !!visible) _layout_invalidate(el->parent, 0);
+        if (visible) el->flags &= ~UI_FLAG_HIDDEN;
+        else el->flags |= UI_FLAG_HIDDEN;
+        
+        for (size_t i = 0; i < list_length(el->children); i++) {
+            sxui_set_visible(list_get(el->children, i), visible);
+        }
+    }
+}
+
+void sxui_set_draggable(UIElement* el, int draggable) {
+    if (el) {
+        if (draggable) el->flags |= UI_FLAG_DRAGGABLE;
+        else el->flags &= ~UI_FLAG_DRAGGABLE;
+    }
+}
+
+void sxui_set_flags(UIElement* el, int flags) {
+    if (!el || el->flags == flags) return;
+    el->flags = flags;
+    _hit_invalidate(el->parent);
+    _layout_invalidate(el->parent, 0);
+}
+
+int sxui_get_flags(UIElement* el) {
+    return el ? el->flags : 0;
+}
+
+<<<<<<< HEAD
+void sxui_set_z_index(UIElement* el, int z) {
+    if (el) {
+        el->z_index = z;
+        _hit_invalidate(el->parent);
+    }
+}
+
+int sxui_get_z_index(UIElement* el) {
+    return el ? el->z_index : 0;
+}
+
+void sxui_set_transparency(UIElement* el, float alpha) {
+    if (el) el->transparency = (alpha < 0.0f) ? 0.0f : (alpha > 1.0f ? 1.0f : alpha);
+}
+
+float sxui_get_transparency(UIElement* el) {
+    return el ? el->transparency : 1.0f;
+}
+
+void sxui_set_custom_color(UIElement* el, Uint32 color) {
+    if (el) {
+        el->custom_color = color;
+        el->has_custom_color = 1;
+    }
+}
+
+Uint32 sxui_get_custom_color(UIElement* el) {
+    return el ? el->custom_color : SX_COLOR_NONE;
+}
+
+const char* sxui_get_text(UIElement* el) {
+    if (!el) return NULL;
+    if (el->type == UI_BUTTON) return ((UIButton*)el)->text;
+    if (el->type == UI_LABEL) return ((UILabel*)el)->text;
+    if (el->type == UI_INPUT) return ((UITextInput*)el)->text;
+    if (el->type == UI_CHECKBOX) return ((UICheckBox*)el)->text;
+=======
+UIElement *sxui_get_last_element(void) { return engine.last_created; }
+
+const char *sxui_get_text(UIElement *el) {
+  if (!el)
+>>>>>>> 410878f (feat: Add new pages and enhance input handling)
+    return NULL;
+}
+
+void sxui_set_text(UIElement* el, const char* text) {
+    if (!el || !text) return;
+    if (el->type == UI_BUTTON) {
+        free(((UIButton*)el)->text);
+        ((UIButton*)el)->text = strdup(text);
+    }
+    else if (el->type == UI_LABEL) {
+        free(((UILabel*)el)->text);
+        ((UILabel*)el)->text = strdup(text);
+    }
+    else if (el->type == UI_INPUT) {
+        UITextInput* inp = (UITextInput*)el;
+        strncpy(inp->text, text, INPUT_MAX - 1);
+        inp->len = strlen(inp->text);
+        inp->cursorPosition = inp->len;
+        inp->selectionAnchor = inp->len;
+    }
+    else if (el->type == UI_CHECKBOX) {
+        free(((UICheckBox*)el)->text);
+        ((UICheckBox*)el)->text = strdup(text);
+    }
+    _text_size_changed(el);
+}
+float sxui_get_value(UIElement* el) {
+    if (!el) return 0.0f;
+    if (el->type == UI_SLIDER) return ((UISlider*)el)->value;
+    if (el->type == UI_CHECKBOX) return (float)((UICheckBox*)el)->value;
+    return 0.0f;
+}
+
+void sxui_set_value(UIElement* el, float value) {
+    if (!el) return;
+    if (el->type == UI_SLIDER) {
+        UISlider* s = (UISlider*)el;
+        s->value = value;
+        if (s->value < 0) s->value = 0;
+        if (s->value > 1) s->value = 1;
+    }
+    else if (el->type == UI_CHECKBOX) {
+        ((UICheckBox*)el)->value = (int)value;
+    }
+}
+
+int sxui_get_dropdown_index(UIElement* el) {
+    if (!el || el->type != UI_DROPDOWN) return -1;
+    return ((UIDropdown*)el)->selected_index;
+}
+
+void sxui_set_gradient(UIElement* el, float* positions, Uint32* colors, int count, float angle) {
+    if (!el || count < 2) return;
+    
+    if (el->effects.gradient.stops) {
+        for (size_t i = 0; i < list_length(el->effects.gradient.stops); i++) {
+            free(list_get(el->effects.gradient.stops, i));
+        }
+        list_free(el->effects.gradient.stops);
+    }
+    
+    el->effects.gradient.stops = list_new();
+    el->effects.gradient.enabled = 1;
+    el->effects.gradient.angle = angle;
+    
+    int valid_count = 0;
+    for (int i = 0; i < count; i++) {
+        if (positions && colors) {
+            GradientStop* stop = malloc(sizeof(GradientStop));
+            stop->position = positions[i];
+            stop->color = colors[i];
+            list_add(el->effects.gradient.stops, stop);
+            valid_count++;
+        } else if (positions && !colors) {
+            GradientStop* stop = malloc(sizeof(GradientStop));
+            stop->position = positions[i];
+            stop->color = SX_COLOR_WHITE;
+            list_add(el->effects.gradient.stops, stop);
+            valid_count++;
+            printf("Warning: Missing color for gradient stop %d, using white\n", i);
+        }
+    }
+    
+    if (valid_count < 2) {
+        printf("Warning: Gradient needs at least 2 valid stops\n");
+        sxui_clear_gradient(el);
+    }
+}
+
+void sxui_clear_gradient(UIElement* el) {
+    if (!el) return;
+    
+    if (el->effects.gradient.stops) {
+        for (size_t i = 0; i < list_length(el->effects.gradient.stops); i++) {
+            free(list_get(el->effects.gradient.stops, i));
+        }
+        list_free(el->effects.gradient.stops);
+        el->effects.gradient.stops = NULL;
+    }
+    
+    el->effects.gradient.enabled = 0;
+}
+
+void sxui_set_outline(UIElement* el, int width, Uint32 color, Uint8 alpha) {
+    if (!el) return;
+    
+    el->effects.outline.enabled = 1;
+    el->effects.outline.width = width;
+    el->effects.outline.color = color;
+    el->effects.outline.alpha = alpha;
+}
+
+void sxui_clear_outline(UIElement* el) {
+    if (!el) return;
+    el->effects.outline.enabled = 0;
+}
+
+void sxui_set_rounded_corners(UIElement* el, int radius) {
+    if (!el) return;
+    
+    el->effects.rounded.enabled = 1;
+    el->effects.rounded.radius = radius;
+}
+
+void sxui_clear_rounded_corners(UIElement* el) {
+    if (!el) return;
+    el->effects.rounded.enabled = 0;
+}
+
+// Tiled canvases have no flat pixel buffer; operations that need one treat
+// them as "not a canvas" and the drawing calls that support tiles check for
+// them first.
+static int _canvas_get(UIElement* canvas, UICanvas** out) {
+    if (!canvas || canvas->type != UI_CANVAS || ((UICanvas*)canvas)->tiles) return 0;
+    *out = (UICanvas*)canvas;
+    return 1;
+}
+
+// Grows the upload rectangle only; used directly when the pixels themselves
+// are unchanged (layer opacity, visibility, blend) and just need recompositing.
+static void _canvas_damage(UICanvas* c, int x1, int y1, int x2, int y2) {
+    if (!c->dirty) {
+        c->dirty_x1 = x1; c->dirty_y1 = y1;
+        c->dirty_x2 = x2; c->dirty_y2 = y2;
+        c->dirty = 1;
+        return;
+    }
+    if (x1 < c->dirty_x1) c->dirty_x1 = x1;
+    if (y1 < c->dirty_y1) c->dirty_y1 = y1;
+    if (x2 > c->dirty_x2) c->dirty_x2 = x2;
+    if (y2 > c->dirty_y2) c->dirty_y2 = y2;
+}
+
+static void _canvas_mark_dirty(UICanvas* c, int x1, int y1, int x2, int y2) {
+    if (x1 < 0) x1 = 0;
+    if (y1 < 0) y1 = 0;
+    if (x2 > c->el.w) x2 = c->el.w;
+    if (y2 > c->el.h) y2 = c->el.h;
+    if (x1 >= x2 || y1 >= y2) return;
+    if (c->history) _history_touch(c->history, x1, y1, x2, y2);
+    if (c->mapped) _mapped_touch(c->mapped, y1, y2);
+    _canvas_damage(c, x1, y1, x2, y2);
+}
+
+// Uploads the accumulated damage once per frame instead of once per draw call.
+static void _canvas_flush(UICanvas* c) {
+    if (c->buffers[0]) {
+        _canvas_acquire_front(c);
+        return;
+    }
+    if (!c->dirty || !c->texture || !c->pixels) return;
+    c->dirty = 0;
+
+    int x2 = c->dirty_x2 < c->el.w ? c->dirty_x2 : c->el.w;
+    int y2 = c->dirty_y2 < c->el.h ? c->dirty_y2 : c->el.h;
+    if (c->dirty_x1 >= x2 || c->dirty_y1 >= y2) return;
+
+    SDL_Rect r = {c->dirty_x1, c->dirty_y1, x2 - c->dirty_x1, y2 - c->dirty_y1};
+    const Uint32* src = c->pixels;
+    if (c->layers) {
+        _canvas_composite(c, &r);
+        src = c->composite;
+    }
+    SDL_UpdateTexture(c->texture, &r, &src[r.y * c->el.w + r.x], c->pitch);
+}
+
+// Columns of a scrolling canvas wrap (see "Scrolling"): a primitive spanning
+// [x1, x2] that runs off one end of the buffer is drawn a second time shifted
+// by the returned offset, which lands the clipped part at the other end.
+static int _ring_shift(UICanvas* c, int x1, int x2) {
+    if (!c->ring) return 0;
+    if (x1 < 0) return c->el.w;
+    if (x2 >= c->el.w) return -c->el.w;
+    return 0;
+}
+
+// Uploads the first copy before the wrapped one is drawn, so the damage stays
+// two strips instead of one full-width rectangle.
+static void _ring_seam(UICanvas* c) {
+    if (c->texture) _canvas_flush(c);
+}
+
+static void _canvas_fill_span(UICanvas* c, int x1, int x2, int y, Uint32 color) {
+    if (y < 0 || y >= c->el.h) return;
+    if (x1 < 0) x1 = 0;
+    if (x2 >= c->el.w) x2 = c->el.w - 1;
+    Uint32* row = &c->pixels[y * c->el.w];
+    for (int x = x1; x <= x2; x++) row[x] = color;
+}
+
+static void _canvas_line(UICanvas* c, int x1, int y1, int x2, int y2, Uint32 color) {
+    int cw = c->el.w, ch = c->el.h;
+
+    // Trivially reject lines entirely on one side of the canvas.
+    if ((x1 < 0 && x2 < 0) || (y1 < 0 && y2 < 0) ||
+        (x1 >= cw && x2 >= cw) || (y1 >= ch && y2 >= ch)) return;
+
+    int inside = x1 >= 0 && x1 < cw && x2 >= 0 && x2 < cw &&
+                 y1 >= 0 && y1 < ch && y2 >= 0 && y2 < ch;
+
+    int dx = abs(x2 - x1);
+    int dy = abs(y2 - y1);
+    int sx = x1 < x2 ? 1 : -1;
+    int sy = y1 < y2 ? 1 : -1;
+    int err = dx - dy;
+    Uint32* px = c->pixels;
+
+    while (1) {
+        if (inside || (x1 >= 0 && x1 < cw && y1 >= 0 && y1 < ch)) {
+            px[y1 * cw + x1] = color;
+        }
+
+        if (x1 == x2 && y1 == y2) break;
+
+        int e2 = 2 * err;
+        if (e2 > -dy) {
+            err -= dy;
+            x1 += sx;
+        }
+        if (e2 < dx) {
+            err += dx;
+            y1 += sy;
+        }
+    }
+}
+
+static void _canvas_rect(UICanvas* c, int x, int y, int w, int h, Uint32 color, int filled) {
+    if (filled) {
+        for (int py = y; py < y + h; py++) {
+            _canvas_fill_span(c, x, x + w - 1, py, color);
+        }
+        return;
+    }
+
+    _canvas_fill_span(c, x, x + w - 1, y, color);
+    _canvas_fill_span(c, x, x + w - 1, y + h - 1, color);
+    for (int py = y; py < y + h; py++) {
+        if (py < 0 || py >= c->el.h) continue;
+        if (x >= 0 && x < c->el.w) c->pixels[py * c->el.w + x] = color;
+        if (x + w - 1 >= 0 && x + w - 1 < c->el.w) c->pixels[py * c->el.w + (x + w - 1)] = color;
+    }
+}
+
+static void _canvas_circle(UICanvas* c, int cx, int cy, int radius, Uint32 color, int filled) {
+    if (radius < 0) return;
+    int cw = c->el.w, ch = c->el.h;
+    if (cx + radius < 0 || cy + radius < 0 || cx - radius >= cw || cy - radius >= ch) return;
+
+    if (filled) {
+        int r2 = radius * radius;
+        int half = radius;
+        // Walk rows outward from the centre; the half-width only shrinks.
+        for (int y = 0; y <= radius; y++) {
+            while (half > 0 && half * half + y * y > r2) half--;
+            _canvas_fill_span(c, cx - half, cx + half, cy - y, color);
+            if (y > 0) _canvas_fill_span(c, cx - half, cx + half, cy + y, color);
+        }
+        return;
+    }
+
+    int inside = cx - radius >= 0 && cy - radius >= 0 && cx + radius < cw && cy + radius < ch;
+    int x = 0;
+    int y = radius;
+    int d = 3 - 2 * radius;
+
+    while (y >= x) {
+        int points[8][2] = {
+            {cx + x, cy + y}, {cx - x, cy + y},
+            {cx + x, cy - y}, {cx - x, cy - y},
+            {cx + y, cy + x}, {cx - y, cy + x},
+            {cx + y, cy - x}, {cx - y, cy - x}
+        };
+
+        for (int i = 0; i < 8; i++) {
+            int px = points[i][0];
+            int py = points[i][1];
+            if (inside || (px >= 0 && px < cw && py >= 0 && py < ch)) {
+                c->pixels[py * cw + px] = color;
             }
-            
-            if (!clicked_ui && engine.focused) {
-                if (engine.focused->type == UI_INPUT) {
-                    trigger_focus((UITextInput*)engine.focused, 0);
-                    SDL_StopTextInput();
-                }
-                if (engine.focused->type == UI_DROPDOWN) {
-                    ((UIDropdown*)engine.focused)->is_open = 0;
-                }
-                engine.focused = NULL;
+        }
+
+        x++;
+        if (d > 0) {
+            y--;
+            d = d + 4 * (x - y) + 10;
+        } else {
+            d = d + 4 * x + 6;
+        }
+    }
+}
+
+// --- Tiled canvases ---
+// A tiled canvas stores its world in CANVAS_TILE-sized blocks that are only
+// allocated when a pixel is first written, each with its own streaming
+// texture. The element's w/h is the on-screen viewport; drawing calls take
+// world coordinates, and pan/zoom only changes which tiles get drawn.
+// Textures are a cache over the pixels: once more than twice the visible
+// tiles (at least CANVAS_TILE_TEXTURES) hold one, the least recently drawn
+// are destroyed and re-uploaded in full if they scroll back into view.
+
+#define CANVAS_TILE_SHIFT 8
+#define CANVAS_TILE (1 << CANVAS_TILE_SHIFT)
+#define CANVAS_TILE_MASK (CANVAS_TILE - 1)
+#define CANVAS_TILE_TEXTURES 64
+
+typedef struct {
+    Uint32* pixels;
+    SDL_Texture* texture;
+    Uint32 used;
+    int dirty;
+    int dirty_x1, dirty_y1, dirty_x2, dirty_y2;
+} CanvasTile;
+
+struct CanvasTiles {
+    int world_w, world_h, cols, rows;
+    CanvasTile** grid;
+    int allocated;
+    int* resident;
+    int resident_count, resident_cap;
+    Uint32 frame;
+    Uint32 fill;
+    float view_x, view_y, zoom;
+};
+
+static CanvasTiles* _canvas_tiles(UIElement* canvas) {
+    if (!canvas || canvas->type != UI_CANVAS) return NULL;
+    return ((UICanvas*)canvas)->tiles;
+}
+
+static void _tile_mark(CanvasTile* tile, int x1, int y1, int x2, int y2) {
+    if (!tile->dirty) {
+        tile->dirty_x1 = x1; tile->dirty_y1 = y1;
+        tile->dirty_x2 = x2; tile->dirty_y2 = y2;
+        tile->dirty = 1;
+        return;
+    }
+    if (x1 < tile->dirty_x1) tile->dirty_x1 = x1;
+    if (y1 < tile->dirty_y1) tile->dirty_y1 = y1;
+    if (x2 > tile->dirty_x2) tile->dirty_x2 = x2;
+    if (y2 > tile->dirty_y2) tile->dirty_y2 = y2;
+}
+
+static CanvasTile* _tiled_tile(CanvasTiles* t, int tx, int ty) {
+    CanvasTile** slot = &t->grid[ty * t->cols + tx];
+    if (*slot) return *slot;
+
+    CanvasTile* tile = calloc(1, sizeof(CanvasTile));
+    if (!tile) return NULL;
+    tile->pixels = malloc(CANVAS_TILE * CANVAS_TILE * sizeof(Uint32));
+    if (!tile->pixels) {
+        free(tile);
+        return NULL;
+    }
+    for (int i = 0; i < CANVAS_TILE * CANVAS_TILE; i++) tile->pixels[i] = t->fill;
+    _tile_mark(tile, 0, 0, CANVAS_TILE, CANVAS_TILE);
+    t->allocated++;
+    *slot = tile;
+    return tile;
+}
+
+static void _tiled_pixel(CanvasTiles* t, int x, int y, Uint32 color) {
+    if ((unsigned)x >= (unsigned)t->world_w || (unsigned)y >= (unsigned)t->world_h) return;
+    CanvasTile* tile = _tiled_tile(t, x >> CANVAS_TILE_SHIFT, y >> CANVAS_TILE_SHIFT);
+    if (!tile) return;
+    int lx = x & CANVAS_TILE_MASK, ly = y & CANVAS_TILE_MASK;
+    tile->pixels[(ly << CANVAS_TILE_SHIFT) + lx] = color;
+    _tile_mark(tile, lx, ly, lx + 1, ly + 1);
+}
+
+static void _tiled_span(CanvasTiles* t, int x1, int x2, int y, Uint32 color) {
+    if (y < 0 || y >= t->world_h) return;
+    if (x1 < 0) x1 = 0;
+    if (x2 >= t->world_w) x2 = t->world_w - 1;
+    int ly = y & CANVAS_TILE_MASK;
+
+    while (x1 <= x2) {
+        int end = (x1 | CANVAS_TILE_MASK) < x2 ? (x1 | CANVAS_TILE_MASK) : x2;
+        CanvasTile* tile = _tiled_tile(t, x1 >> CANVAS_TILE_SHIFT, y >> CANVAS_TILE_SHIFT);
+        if (!tile) return;
+        Uint32* row = &tile->pixels[ly << CANVAS_TILE_SHIFT];
+        for (int x = x1 & CANVAS_TILE_MASK; x <= (end & CANVAS_TILE_MASK); x++) row[x] = color;
+        _tile_mark(tile, x1 & CANVAS_TILE_MASK, ly, (end & CANVAS_TILE_MASK) + 1, ly + 1);
+        x1 = end + 1;
+    }
+}
+
+// The tiled primitives walk the same pixels as _canvas_line/_rect/_circle so
+// a shape looks identical on either kind of canvas.
+static void _tiled_line(CanvasTiles* t, int x1, int y1, int x2, int y2, Uint32 color) {
+    if ((x1 < 0 && x2 < 0) || (y1 < 0 && y2 < 0) ||
+        (x1 >= t->world_w && x2 >= t->world_w) || (y1 >= t->world_h && y2 >= t->world_h)) return;
+
+    int dx = abs(x2 - x1);
+    int dy = abs(y2 - y1);
+    int sx = x1 < x2 ? 1 : -1;
+    int sy = y1 < y2 ? 1 : -1;
+    int err = dx - dy;
+
+    while (1) {
+        _tiled_pixel(t, x1, y1, color);
+        if (x1 == x2 && y1 == y2) break;
+
+        int e2 = 2 * err;
+        if (e2 > -dy) {
+            err -= dy;
+            x1 += sx;
+        }
+        if (e2 < dx) {
+            err += dx;
+            y1 += sy;
+        }
+    }
+}
+
+static void _tiled_rect(CanvasTiles* t, int x, int y, int w, int h, Uint32 color, int filled) {
+    if (filled) {
+        for (int py = y; py < y + h; py++) _tiled_span(t, x, x + w - 1, py, color);
+        return;
+    }
+    _tiled_span(t, x, x + w - 1, y, color);
+    _tiled_span(t, x, x + w - 1, y + h - 1, color);
+    for (int py = y; py < y + h; py++) {
+        _tiled_pixel(t, x, py, color);
+        _tiled_pixel(t, x + w - 1, py, color);
+    }
+}
+
+static void _tiled_circle(CanvasTiles* t, int cx, int cy, int radius, Uint32 color, int filled) {
+    if (radius < 0) return;
+    if (filled) {
+        int r2 = radius * radius;
+        int half = radius;
+        for (int y = 0; y <= radius; y++) {
+            while (half > 0 && half * half + y * y > r2) half--;
+            _tiled_span(t, cx - half, cx + half, cy - y, color);
+            if (y > 0) _tiled_span(t, cx - half, cx + half, cy + y, color);
+        }
+        return;
+    }
+
+    int x = 0;
+    int y = radius;
+    int d = 3 - 2 * radius;
+    while (y >= x) {
+        _tiled_pixel(t, cx + x, cy + y, color); _tiled_pixel(t, cx - x, cy + y, color);
+        _tiled_pixel(t, cx + x, cy - y, color); _tiled_pixel(t, cx - x, cy - y, color);
+        _tiled_pixel(t, cx + y, cy + x, color); _tiled_pixel(t, cx - y, cy + x, color);
+        _tiled_pixel(t, cx + y, cy - x, color); _tiled_pixel(t, cx - y, cy - x, color);
+
+        x++;
+        if (d > 0) {
+            y--;
+            d = d + 4 * (x - y) + 10;
+        } else {
+            d = d + 4 * x + 6;
+        }
+    }
+}
+
+// Blits run once per overlapped tile against a tile-sized view of the canvas;
+// the sampling only depends on the offset from dst, so seams line up exactly.
+static void _tiled_blit(CanvasTiles* t, const Uint32* src, int sw, int sh, int pitch,
+                        SDL_Rect dst, int flags) {
+    int x1 = dst.x < 0 ? 0 : dst.x, y1 = dst.y < 0 ? 0 : dst.y;
+    int x2 = dst.x + dst.w < t->world_w ? dst.x + dst.w : t->world_w;
+    int y2 = dst.y + dst.h < t->world_h ? dst.y + dst.h : t->world_h;
+    if (x1 >= x2 || y1 >= y2) return;
+
+    UICanvas view = {0};
+    view.el.type = UI_CANVAS;
+    view.el.w = view.el.h = CANVAS_TILE;
+    view.pitch = CANVAS_TILE * sizeof(Uint32);
+
+    for (int ty = y1 >> CANVAS_TILE_SHIFT; ty <= (y2 - 1) >> CANVAS_TILE_SHIFT; ty++) {
+        for (int tx = x1 >> CANVAS_TILE_SHIFT; tx <= (x2 - 1) >> CANVAS_TILE_SHIFT; tx++) {
+            CanvasTile* tile = _tiled_tile(t, tx, ty);
+            if (!tile) continue;
+            SDL_Rect local = {dst.x - (tx << CANVAS_TILE_SHIFT), dst.y - (ty << CANVAS_TILE_SHIFT), dst.w, dst.h};
+            view.pixels = tile->pixels;
+            view.dirty = 0;
+            sxui_canvas_blit((UIElement*)&view, src, sw, sh, pitch, &local, flags);
+            if (view.dirty) _tile_mark(tile, view.dirty_x1, view.dirty_y1, view.dirty_x2, view.dirty_y2);
+        }
+    }
+}
+
+static void _tiled_clear(CanvasTiles* t, Uint32 color) {
+    for (int i = 0; i < t->cols * t->rows; i++) {
+        CanvasTile* tile = t->grid[i];
+        if (!tile) continue;
+        if (tile->texture) SDL_DestroyTexture(tile->texture);
+        free(tile->pixels);
+        free(tile);
+        t->grid[i] = NULL;
+    }
+    t->allocated = 0;
+    t->resident_count = 0;
+    t->fill = color;
+}
+
+static void _tiled_free(UICanvas* c) {
+    if (!c->tiles) return;
+    _tiled_clear(c->tiles, 0);
+    free(c->tiles->resident);
+    free(c->tiles->grid);
+    free(c->tiles);
+    c->tiles = NULL;
+}
+
+static UIElement* _tiled_clone(UICanvas* src) {
+    CanvasTiles* s = src->tiles;
+    UIElement* clone = sxui_canvas_tiled(NULL, src->el.x, src->el.y, src->el.w, src->el.h,
+                                         s->world_w, s->world_h);
+    if (!clone) return NULL;
+    CanvasTiles* dst = ((UICanvas*)clone)->tiles;
+    dst->fill = s->fill;
+    dst->view_x = s->view_x;
+    dst->view_y = s->view_y;
+    dst->zoom = s->zoom;
+    for (int i = 0; i < s->cols * s->rows; i++) {
+        if (!s->grid[i]) continue;
+        CanvasTile* tile = _tiled_tile(dst, i % dst->cols, i / dst->cols);
+        if (tile) memcpy(tile->pixels, s->grid[i]->pixels, CANVAS_TILE * CANVAS_TILE * sizeof(Uint32));
+    }
+    return clone;
+}
+
+static int _tiled_keep_texture(CanvasTiles* t, int index) {
+    if (t->resident_count == t->resident_cap) {
+        int cap = t->resident_cap ? t->resident_cap * 2 : CANVAS_TILE_TEXTURES;
+        int* resident = realloc(t->resident, cap * sizeof(int));
+        if (!resident) return 0;
+        t->resident = resident;
+        t->resident_cap = cap;
+    }
+    t->resident[t->resident_count++] = index;
+    return 1;
+}
+
+// Drops the least recently drawn textures until at most `cap` remain. Tiles
+// drawn this frame are never chosen, so the scan stops once only they are left.
+static void _tiled_evict(CanvasTiles* t, int cap) {
+    while (t->resident_count > cap) {
+        int oldest = -1;
+        Uint32 age = 0;
+        for (int i = 0; i < t->resident_count; i++) {
+            Uint32 a = t->frame - t->grid[t->resident[i]]->used;
+            if (a > age) {
+                age = a;
+                oldest = i;
             }
         }
-<<<<<<< HEAD
-        
-        if (e.type == SDL_MOUSEBUTTONUP) {
-            if (engine.dragging_el) {
-                engine.dragging_el = NULL;
+        if (oldest < 0) return;
+        CanvasTile* tile = t->grid[t->resident[oldest]];
+        SDL_DestroyTexture(tile->texture);
+        tile->texture = NULL;
+        t->resident[oldest] = t->resident[--t->resident_count];
+    }
+}
+
+// Only tiles intersecting the viewport are uploaded and drawn. Destination
+// edges are computed per tile boundary so neighbouring tiles never leave gaps
+// at fractional zoom levels.
+static void _tiled_render(UICanvas* c, int wx, int wy, Uint8 alpha) {
+    CanvasTiles* t = c->tiles;
+    float zoom = t->zoom;
+    t->frame++;
+    SDL_Rect view = {wx, wy, c->el.w, c->el.h};
+
+    SDL_Rect old_clip;
+    SDL_bool had_clip = SDL_RenderIsClipEnabled(engine.renderer);
+    SDL_RenderGetClipRect(engine.renderer, &old_clip);
+    SDL_Rect clip = view;
+    if (had_clip && !SDL_IntersectRect(&view, &old_clip, &clip)) return;
+    SDL_RenderSetClipRect(engine.renderer, &clip);
+
+    float vx2 = t->view_x + c->el.w / zoom, vy2 = t->view_y + c->el.h / zoom;
+    int tx1 = (int)floorf(t->view_x) >> CANVAS_TILE_SHIFT, ty1 = (int)floorf(t->view_y) >> CANVAS_TILE_SHIFT;
+    int tx2 = (int)floorf(vx2) >> CANVAS_TILE_SHIFT, ty2 = (int)floorf(vy2) >> CANVAS_TILE_SHIFT;
+    if (tx1 < 0) tx1 = 0;
+    if (ty1 < 0) ty1 = 0;
+    if (tx2 >= t->cols) tx2 = t->cols - 1;
+    if (ty2 >= t->rows) ty2 = t->rows - 1;
+
+    Uint8 fr, fg, fb, fa;
+    uint_to_rgba(t->fill, &fr, &fg, &fb, &fa);
+    Uint32 fill = rgba_to_uint(fr, fg, fb, (Uint8)(fa * alpha / 255));
+
+    for (int ty = ty1; ty <= ty2; ty++) {
+        int wy1 = ty << CANVAS_TILE_SHIFT;
+        int wy2 = wy1 + CANVAS_TILE < t->world_h ? wy1 + CANVAS_TILE : t->world_h;
+        int sy1 = wy + (int)floorf((wy1 - t->view_y) * zoom);
+        int sy2 = wy + (int)floorf((wy2 - t->view_y) * zoom);
+
+        for (int tx = tx1; tx <= tx2; tx++) {
+            int wx1 = tx << CANVAS_TILE_SHIFT;
+            int wx2 = wx1 + CANVAS_TILE < t->world_w ? wx1 + CANVAS_TILE : t->world_w;
+            int sx1 = wx + (int)floorf((wx1 - t->view_x) * zoom);
+            int sx2 = wx + (int)floorf((wx2 - t->view_x) * zoom);
+            if (sx1 >= sx2 || sy1 >= sy2) continue;
+            SDL_Rect dst = {sx1, sy1, sx2 - sx1, sy2 - sy1};
+
+            CanvasTile* tile = t->grid[ty * t->cols + tx];
+            if (!tile) {
+                if (fa) _draw_rect(dst.x, dst.y, dst.w, dst.h, fill);
+                continue;
             }
-            if (engine.focused && engine.focused->type == UI_SLIDER) {
-                engine.focused = NULL;
+            if (!tile->texture) {
+                tile->texture = SDL_CreateTexture(engine.renderer, SDL_PIXELFORMAT_RGBA8888,
+                                                  SDL_TEXTUREACCESS_STREAMING, CANVAS_TILE, CANVAS_TILE);
+                if (!tile->texture) continue;
+                if (!_tiled_keep_texture(t, ty * t->cols + tx)) {
+                    SDL_DestroyTexture(tile->texture);
+                    tile->texture = NULL;
+                    continue;
+                }
+                SDL_SetTextureBlendMode(tile->texture, SDL_BLENDMODE_BLEND);
+                _tile_mark(tile, 0, 0, CANVAS_TILE, CANVAS_TILE);
             }
-=======
-      }
+            tile->used = t->frame;
+            if (tile->dirty) {
+                SDL_Rect r = {tile->dirty_x1, tile->dirty_y1,
+                              tile->dirty_x2 - tile->dirty_x1, tile->dirty_y2 - tile->dirty_y1};
+                SDL_UpdateTexture(tile->texture, &r, &tile->pixels[(r.y << CANVAS_TILE_SHIFT) + r.x],
+                                  CANVAS_TILE * sizeof(Uint32));
+                tile->dirty = 0;
+            }
+            SDL_Rect src = {0, 0, wx2 - wx1, wy2 - wy1};
+            SDL_SetTextureAlphaMod(tile->texture, alpha);
+            SDL_RenderCopy(engine.renderer, tile->texture, &src, &dst);
+        }
+    }
+
+    int visible = (tx2 - tx1 + 1) * (ty2 - ty1 + 1);
+    _tiled_evict(t, visible * 2 > CANVAS_TILE_TEXTURES ? visible * 2 : CANVAS_TILE_TEXTURES);
+    SDL_RenderSetClipRect(engine.renderer, had_clip ? &old_clip : NULL);
+}
+
+UIElement* sxui_canvas_tiled(UIElement* parent, int x, int y, int w, int h, int world_w, int world_h) {
+    if (world_w <= 0 || world_h <= 0) return NULL;
+    UICanvas* c = calloc(1, sizeof(UICanvas));
+    CanvasTiles* t = calloc(1, sizeof(CanvasTiles));
+    if (!c || !t) {
+        free(c);
+        free(t);
+        return NULL;
+    }
+    t->world_w = world_w;
+    t->world_h = world_h;
+    t->cols = (world_w + CANVAS_TILE - 1) >> CANVAS_TILE_SHIFT;
+    t->rows = (world_h + CANVAS_TILE - 1) >> CANVAS_TILE_SHIFT;
+    t->grid = calloc((size_t)t->cols * t->rows, sizeof(CanvasTile*));
+    t->zoom = 1.0f;
+    if (!t->grid) {
+        free(t);
+        free(c);
+        return NULL;
+    }
+
+    init_base(&c->el, x, y, w, h, UI_CANVAS);
+    c->tiles = t;
+    _add_to_parent(parent, (UIElement*)c);
+    return (UIElement*)c;
+}
+
+int sxui_canvas_is_tiled(UIElement* canvas) {
+    return _canvas_tiles(canvas) != NULL;
+}
+
+void sxui_canvas_set_view(UIElement* canvas, float x, float y, float zoom) {
+    CanvasTiles* t = _canvas_tiles(canvas);
+    if (!t) return;
+    t->view_x = x;
+    t->view_y = y;
+    t->zoom = zoom > 0.01f ? zoom : 0.01f;
+}
+
+void sxui_canvas_get_view(UIElement* canvas, float* x, float* y, float* zoom) {
+    CanvasTiles* t = _canvas_tiles(canvas);
+    if (x) *x = t ? t->view_x : 0;
+    if (y) *y = t ? t->view_y : 0;
+    if (zoom) *zoom = t ? t->zoom : 1.0f;
+}
+
+void sxui_canvas_view_to_world(UIElement* canvas, int vx, int vy, float* x, float* y) {
+    CanvasTiles* t = _canvas_tiles(canvas);
+    if (x) *x = t ? t->view_x + vx / t->zoom : (float)vx;
+    if (y) *y = t ? t->view_y + vy / t->zoom : (float)vy;
+}
+
+int sxui_canvas_get_tile_count(UIElement* canvas) {
+    CanvasTiles* t = _canvas_tiles(canvas);
+    return t ? t->allocated : 0;
+}
+
+void sxui_canvas_clear(UIElement* canvas, Uint32 color) {
+    UICanvas* c;
+    CanvasTiles* t = _canvas_tiles(canvas);
+    if (t) {
+        _tiled_clear(t, color);
+        return;
+    }
+    if (!_canvas_get(canvas, &c)) return;
+    
+    for (int i = 0; i < canvas->w * canvas->h; i++) {
+        c->pixels[i] = color;
+    }
+    
+    _canvas_mark_dirty(c, 0, 0, canvas->w, canvas->h);
+}
+
+void sxui_canvas_draw_pixel(UIElement* canvas, int x, int y, Uint32 color) {
+    UICanvas* c;
+    CanvasTiles* t = _canvas_tiles(canvas);
+    if (t) {
+        _tiled_pixel(t, x, y, color);
+        return;
+    }
+    if (!_canvas_get(canvas, &c)) return;
+    
+    if (c->ring && canvas->w > 0) x += _ring_shift(c, x, x);
+    if (x < 0 || x >= canvas->w || y < 0 || y >= canvas->h) return;
+    
+    c->pixels[y * canvas->w + x] = color;
+    _canvas_mark_dirty(c, x, y, x + 1, y + 1);
+}
+
+void sxui_canvas_draw_line(UIElement* canvas, int x1, int y1, int x2, int y2, Uint32 color) {
+    UICanvas* c;
+    CanvasTiles* t = _canvas_tiles(canvas);
+    if (t) {
+        _tiled_line(t, x1, y1, x2, y2, color);
+        return;
+    }
+    if (!_canvas_get(canvas, &c)) return;
+    
+    _canvas_line(c, x1, y1, x2, y2, color);
+    _canvas_mark_dirty(c, (x1 < x2 ? x1 : x2), (y1 < y2 ? y1 : y2),
+                       (x1 > x2 ? x1 : x2) + 1, (y1 > y2 ? y1 : y2) + 1);
+
+    int s = _ring_shift(c, (x1 < x2 ? x1 : x2), (x1 > x2 ? x1 : x2));
+    if (!s) return;
+    _ring_seam(c);
+    _canvas_line(c, x1 + s, y1, x2 + s, y2, color);
+    _canvas_mark_dirty(c, (x1 < x2 ? x1 : x2) + s, (y1 < y2 ? y1 : y2),
+                       (x1 > x2 ? x1 : x2) + s + 1, (y1 > y2 ? y1 : y2) + 1);
+}
+
+void sxui_canvas_draw_rect(UIElement* canvas, int x, int y, int w, int h, Uint32 color, int filled) {
+    UICanvas* c;
+    CanvasTiles* t = _canvas_tiles(canvas);
+    if (t) {
+        _tiled_rect(t, x, y, w, h, color, filled);
+        return;
+    }
+    if (!_canvas_get(canvas, &c)) return;
+    
+    _canvas_rect(c, x, y, w, h, color, filled);
+    _canvas_mark_dirty(c, (w < 0 ? x + w - 1 : x), (h < 0 ? y + h - 1 : y),
+                       (w < 0 ? x : x + w) + 1, (h < 0 ? y : y + h) + 1);
 
-      if (!hit && engine.focused) { // Clicked outside focused element
-        if (engine.focused->type == UI_INPUT) {
-          trigger_focus((UITextInput *)engine.focused, 0);
-          SDL_StopTextInput();
->>>>>>> 410878f (feat: Add new pages and enhance input handling)
-        }
-        
-        if (e.type == SDL_MOUSEWHEEL) {
-            UIElement* hit = _get_hit(engine.root, mx, my, 0, 0);
-            while (hit) {
-                if (hit->type == UI_FRAME && (hit->flags & UI_SCROLLABLE)) {
-                    UIFrame* f = (UIFrame*)hit;
-                    f->scroll_y -= e.wheel.y * 40;
-                    if (f->scroll_y < 0) f->scroll_y = 0;
-                    int limit = f->content_height - hit->h;
-                    if (f->scroll_y > limit && limit > 0) f->scroll_y = limit;
-                    f->last_scroll_time = SDL_GetTicks();
-                    break;
-                }
-                hit = hit->parent;
-            }
-        }
+    int s = _ring_shift(c, (w < 0 ? x + w - 1 : x), (w < 0 ? x : x + w - 1));
+    if (!s) return;
+    _ring_seam(c);
+    _canvas_rect(c, x + s, y, w, h, color, filled);
+    _canvas_mark_dirty(c, (w < 0 ? x + w - 1 : x) + s, (h < 0 ? y + h - 1 : y),
+                       (w < 0 ? x : x + w) + s + 1, (h < 0 ? y : y + h) + 1);
+}
 
-<<<<<<< HEAD
-        if (engine.focused && engine.focused->type == UI_INPUT) {
-            if (e.type == SDL_TEXTINPUT || e.type == SDL_KEYDOWN) {
-                read_input((UITextInput*)engine.focused, &e);
-            }
-=======
-    if (e.type == SDL_MOUSEBUTTONUP) {
-      int btn_idx = e.button.button - 1;
-      if (btn_idx >= 0 && btn_idx < 8) {
-        engine.mouse_buttons[btn_idx] = 0;
-      }
+void sxui_canvas_draw_circle(UIElement* canvas, int cx, int cy, int radius, Uint32 color, int filled) {
+    UICanvas* c;
+    CanvasTiles* t = _canvas_tiles(canvas);
+    if (t) {
+        _tiled_circle(t, cx, cy, radius, color, filled);
+        return;
+    }
+    if (!_canvas_get(canvas, &c)) return;
+    
+    _canvas_circle(c, cx, cy, radius, color, filled);
+    _canvas_mark_dirty(c, cx - radius, cy - radius, cx + radius + 1, cy + radius + 1);
 
-      UIElement *hit = _get_hit(engine.root, mx, my, 0, 0);
-      if (hit == engine.mouse_pressed_element &&
-          e.button.button == engine.mouse_pressed_button &&
-          engine.dragging_el == NULL) {
-        trigger_mouse_click(hit, e.button.button);
-      }
-      engine.mouse_pressed_element = NULL;
-      engine.mouse_pressed_button = 0;
+    int s = radius >= 0 ? _ring_shift(c, cx - radius, cx + radius) : 0;
+    if (!s) return;
+    _ring_seam(c);
+    _canvas_circle(c, cx + s, cy, radius, color, filled);
+    _canvas_mark_dirty(c, cx + s - radius, cy - radius, cx + s + radius + 1, cy + radius + 1);
+}
 
-      if (engine.dragging_el) {
-        engine.dragging_el = NULL;
-      }
-      if (engine.focused && engine.focused->type == UI_SLIDER) {
-        engine.focused = NULL;
-      }
+// Batched submission: one type check, one damage rect and no per-primitive
+// upload, so large scenes are limited by pixel writes rather than call overhead.
+
+void sxui_canvas_draw_points(UIElement* canvas, const SXPoint* points, int count) {
+    UICanvas* c;
+    CanvasTiles* t = _canvas_tiles(canvas);
+    if (t && points) {
+        for (int i = 0; i < count; i++) _tiled_pixel(t, points[i].x, points[i].y, points[i].color);
+        return;
     }
+    if (!_canvas_get(canvas, &c) || !points || count <= 0) return;
 
-    if (e.type == SDL_MOUSEWHEEL) {
-      UIElement *hit = _get_hit(engine.root, mx, my, 0, 0);
-      while (hit) {
-        if (hit->type == UI_FRAME && (hit->flags & UI_SCROLLABLE)) {
-          UIFrame *f = (UIFrame *)hit;
-          f->scroll_y -= e.wheel.y * 40;
-          if (f->scroll_y < 0)
-            f->scroll_y = 0;
-          int limit = f->content_height - hit->h;
-          if (f->scroll_y > limit && limit > 0)
-            f->scroll_y = limit;
-          f->last_scroll_time = SDL_GetTicks();
-          break;
->>>>>>> 410878f (feat: Add new pages and enhance input handling)
+    int cw = canvas->w, ch = canvas->h;
+    int bx1 = cw, by1 = ch, bx2 = 0, by2 = 0;
+    for (int i = 0; i < count; i++) {
+        int x = points[i].x, y = points[i].y;
+        x += _ring_shift(c, x, x);
+        if ((unsigned)x >= (unsigned)cw || (unsigned)y >= (unsigned)ch) continue;
+        c->pixels[y * cw + x] = points[i].color;
+        if (x < bx1) bx1 = x;
+        if (y < by1) by1 = y;
+        if (x >= bx2) bx2 = x + 1;
+        if (y >= by2) by2 = y + 1;
+    }
+    _canvas_mark_dirty(c, bx1, by1, bx2, by2);
+}
+
+void sxui_canvas_draw_lines(UIElement* canvas, const SXLine* lines, int count) {
+    UICanvas* c;
+    CanvasTiles* t = _canvas_tiles(canvas);
+    if (t && lines) {
+        for (int i = 0; i < count; i++) {
+            _tiled_line(t, lines[i].x1, lines[i].y1, lines[i].x2, lines[i].y2, lines[i].color);
         }
+        return;
     }
+    if (!_canvas_get(canvas, &c) || !lines || count <= 0) return;
 
-    if (engine.dragging_el) {
-        engine.dragging_el->x = mx - engine.drag_off_x;
-        engine.dragging_el->y = my - engine.drag_off_y;
+    int bx1 = INT_MAX, by1 = INT_MAX, bx2 = INT_MIN, by2 = INT_MIN;
+    for (int i = 0; i < count; i++) {
+        const SXLine* l = &lines[i];
+        _canvas_line(c, l->x1, l->y1, l->x2, l->y2, l->color);
+        int lx1 = l->x1 < l->x2 ? l->x1 : l->x2;
+        int lx2 = l->x1 > l->x2 ? l->x1 : l->x2;
+        int ly1 = l->y1 < l->y2 ? l->y1 : l->y2;
+        int ly2 = l->y1 > l->y2 ? l->y1 : l->y2;
+        if (lx1 < bx1) bx1 = lx1;
+        if (ly1 < by1) by1 = ly1;
+        if (lx2 > bx2) bx2 = lx2;
+        if (ly2 > by2) by2 = ly2;
     }
+    _canvas_mark_dirty(c, bx1, by1, bx2 + 1, by2 + 1);
+    if (!_ring_shift(c, bx1, bx2)) return;
 
-<<<<<<< HEAD
-    if (SDL_GetMouseState(NULL, NULL) & SDL_BUTTON(SDL_BUTTON_LEFT)) {
-        if (engine.focused && engine.focused->type == UI_SLIDER) {
-            UISlider* s = (UISlider*)engine.focused;
-            int wx = s->el.x;
-            UIElement* p = s->el.parent;
-            while (p) {
-                wx += p->x;
-                if (p->type == UI_FRAME) {
-                    wx -= ((UIFrame*)p)->scroll_y;
-                }
-                p = p->parent;
-            }
-            float old_val = s->value;
-            s->value = (float)(mx - wx) / s->el.w;
-            if (s->value < 0) s->value = 0;
-            if (s->value > 1) s->value = 1;
-            if (fabs(s->value - old_val) > 0.001f) {
-                trigger_value_changed(s, s->value);
-            }
-=======
-  if (engine.dragging_el) {
-    engine.dragging_el->x = mx - engine.drag_off_x;
-    engine.dragging_el->y = my - engine.drag_off_y;
-  }
+    _ring_seam(c);
+    for (int i = 0; i < count; i++) {
+        const SXLine* l = &lines[i];
+        int lx1 = l->x1 < l->x2 ? l->x1 : l->x2;
+        int lx2 = l->x1 > l->x2 ? l->x1 : l->x2;
+        int s = _ring_shift(c, lx1, lx2);
+        if (!s) continue;
+        _canvas_line(c, l->x1 + s, l->y1, l->x2 + s, l->y2, l->color);
+        _canvas_mark_dirty(c, lx1 + s, (l->y1 < l->y2 ? l->y1 : l->y2),
+                           lx2 + s + 1, (l->y1 > l->y2 ? l->y1 : l->y2) + 1);
+    }
+}
 
-  if (sxui_is_mouse_button_down(SDL_BUTTON_LEFT)) { // Use new public function
-    if (engine.focused && engine.focused->type == UI_SLIDER) {
-      UISlider *s = (UISlider *)engine.focused;
-      int wx = s->el.x;
-      UIElement *p = s->el.parent;
-      while (p) {
-        wx += p->x;
-        if (p->type == UI_FRAME) {
-          wx -= ((UIFrame *)p)->scroll_y;
->>>>>>> 410878f (feat: Add new pages and enhance input handling)
+void sxui_canvas_draw_rects(UIElement* canvas, const SXRect* rects, int count) {
+    UICanvas* c;
+    CanvasTiles* t = _canvas_tiles(canvas);
+    if (t && rects) {
+        for (int i = 0; i < count; i++) {
+            _tiled_rect(t, rects[i].x, rects[i].y, rects[i].w, rects[i].h, rects[i].color, rects[i].filled);
         }
+        return;
+    }
+    if (!_canvas_get(canvas, &c) || !rects || count <= 0) return;
+
+    int bx1 = INT_MAX, by1 = INT_MAX, bx2 = INT_MIN, by2 = INT_MIN;
+    for (int i = 0; i < count; i++) {
+        const SXRect* r = &rects[i];
+        _canvas_rect(c, r->x, r->y, r->w, r->h, r->color, r->filled);
+        int rx1 = r->w < 0 ? r->x + r->w - 1 : r->x;
+        int ry1 = r->h < 0 ? r->y + r->h - 1 : r->y;
+        int rx2 = r->w < 0 ? r->x : r->x + r->w;
+        int ry2 = r->h < 0 ? r->y : r->y + r->h;
+        if (rx1 < bx1) bx1 = rx1;
+        if (ry1 < by1) by1 = ry1;
+        if (rx2 > bx2) bx2 = rx2;
+        if (ry2 > by2) by2 = ry2;
+    }
+    _canvas_mark_dirty(c, bx1, by1, bx2 + 1, by2 + 1);
+    if (!_ring_shift(c, bx1, bx2 - 1)) return;
+
+    _ring_seam(c);
+    for (int i = 0; i < count; i++) {
+        const SXRect* r = &rects[i];
+        int rx1 = r->w < 0 ? r->x + r->w - 1 : r->x;
+        int rx2 = r->w < 0 ? r->x : r->x + r->w - 1;
+        int s = _ring_shift(c, rx1, rx2);
+        if (!s) continue;
+        _canvas_rect(c, r->x + s, r->y, r->w, r->h, r->color, r->filled);
+        _canvas_mark_dirty(c, rx1 + s, (r->h < 0 ? r->y + r->h - 1 : r->y),
+                           rx2 + s + 2, (r->h < 0 ? r->y : r->y + r->h) + 1);
     }
 }
 
-UIElement* sxui_frame(UIElement* p, int x, int y, int w, int h, int flags) {
-    UIFrame* f = calloc(1, sizeof(UIFrame));
-    init_base(&f->el, x, y, w, h, UI_FRAME);
-    f->el.flags = flags;
-    f->padding = 10;
-    f->spacing = 8;
-    f->scroll_bar_width = 6;
-    _add_to_parent(p, (UIElement*)f);
-    return (UIElement*)f;
+void sxui_canvas_draw_circles(UIElement* canvas, const SXCircle* circles, int count) {
+    UICanvas* c;
+    CanvasTiles* t = _canvas_tiles(canvas);
+    if (t && circles) {
+        for (int i = 0; i < count; i++) {
+            const SXCircle* ci = &circles[i];
+            _tiled_circle(t, ci->cx, ci->cy, ci->radius, ci->color, ci->filled);
+        }
+        return;
+    }
+    if (!_canvas_get(canvas, &c) || !circles || count <= 0) return;
+
+    int bx1 = INT_MAX, by1 = INT_MAX, bx2 = INT_MIN, by2 = INT_MIN;
+    for (int i = 0; i < count; i++) {
+        const SXCircle* ci = &circles[i];
+        if (ci->radius < 0) continue;
+        _canvas_circle(c, ci->cx, ci->cy, ci->radius, ci->color, ci->filled);
+        if (ci->cx - ci->radius < bx1) bx1 = ci->cx - ci->radius;
+        if (ci->cy - ci->radius < by1) by1 = ci->cy - ci->radius;
+        if (ci->cx + ci->radius + 1 > bx2) bx2 = ci->cx + ci->radius + 1;
+        if (ci->cy + ci->radius + 1 > by2) by2 = ci->cy + ci->radius + 1;
+    }
+    _canvas_mark_dirty(c, bx1, by1, bx2, by2);
+    if (!_ring_shift(c, bx1, bx2 - 1)) return;
+
+    _ring_seam(c);
+    for (int i = 0; i < count; i++) {
+        const SXCircle* ci = &circles[i];
+        int s = ci->radius >= 0 ? _ring_shift(c, ci->cx - ci->radius, ci->cx + ci->radius) : 0;
+        if (!s) continue;
+        _canvas_circle(c, ci->cx + s, ci->cy, ci->radius, ci->color, ci->filled);
+        _canvas_mark_dirty(c, ci->cx + s - ci->radius, ci->cy - ci->radius,
+                           ci->cx + s + ci->radius + 1, ci->cy + ci->radius + 1);
+    }
 }
 
-UIElement* sxui_button(UIElement* p, const char* label, ClickCallback cb) {
-    UIButton* b = calloc(1, sizeof(UIButton));
-    init_base(&b->el, 0, 0, 0, 0, UI_BUTTON);
-    b->text = strdup(label);
-    b->onClick = list_new();
-    if (cb) bind_event(b->onClick, cb);
-    _add_to_parent(p, (UIElement*)b);
-    return (UIElement*)b;
+// Straight-alpha "over" for RGBA8888. The source alpha byte is forced to 255
+// so the same weight produces the destination alpha: a + da * (255 - a) / 255.
+static inline Uint32 _blend_pixel(Uint32 dst, Uint32 src) {
+    Uint32 a = src & 0xFF;
+    if (a == 255) return src;
+    if (a == 0) return dst;
+    Uint32 s = src | 0xFF;
+    Uint32 out = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        Uint32 sc = (s >> shift) & 0xFF;
+        Uint32 dc = (dst >> shift) & 0xFF;
+        Uint32 v = sc * a + dc * (255 - a) + 128;
+        out |= (((v + (v >> 8)) >> 8) & 0xFF) << shift;
+    }
+    return out;
+}
+
+static void _blend_row(Uint32* dst, const Uint32* src, int n) {
+    int i = 0;
+#ifdef SXUI_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alpha_lane = _mm_set1_epi32(0xFF);
+    const __m128i c255 = _mm_set1_epi16(255);
+    const __m128i c128 = _mm_set1_epi16(128);
+    for (; i + 4 <= n; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        // Sprites are mostly fully opaque or fully clear; skip the maths for those quads.
+        int alpha = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(s, alpha_lane), alpha_lane));
+        if (alpha == 0xFFFF) {
+            _mm_storeu_si128((__m128i*)(dst + i), s);
+            continue;
+        }
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(s, alpha_lane), zero)) == 0xFFFF) continue;
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i s_op = _mm_or_si128(s, alpha_lane);
+
+        __m128i s_lo = _mm_unpacklo_epi8(s_op, zero);
+        __m128i s_hi = _mm_unpackhi_epi8(s_op, zero);
+        __m128i d_lo = _mm_unpacklo_epi8(d, zero);
+        __m128i d_hi = _mm_unpackhi_epi8(d, zero);
+
+        // Alpha sits in the lowest byte of each pixel; broadcast it per pixel.
+        __m128i a_lo = _mm_unpacklo_epi8(s, zero);
+        __m128i a_hi = _mm_unpackhi_epi8(s, zero);
+        a_lo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(a_lo, 0x00), 0x00);
+        a_hi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(a_hi, 0x00), 0x00);
+
+        __m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(s_lo, a_lo),
+                                   _mm_mullo_epi16(d_lo, _mm_sub_epi16(c255, a_lo))), c128);
+        __m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(s_hi, a_hi),
+                                   _mm_mullo_epi16(d_hi, _mm_sub_epi16(c255, a_hi))), c128);
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; i < n; i++) dst[i] = _blend_pixel(dst[i], src[i]);
 }
 
-UIElement* sxui_label(UIElement* p, const char* text) {
-    UILabel* l = calloc(1, sizeof(UILabel));
-    init_base(&l->el, 0, 0, 0, 0, UI_LABEL);
-    l->text = strdup(text);
-    _add_to_parent(p, (UIElement*)l);
-    return (UIElement*)l;
+static inline Uint32 _bilinear_pixel(Uint32 p00, Uint32 p01, Uint32 p10, Uint32 p11,
+                                     Uint32 fx, Uint32 fy) {
+    Uint32 res = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        Uint32 t = (((p00 >> shift) & 0xFF) * (256 - fx) + ((p01 >> shift) & 0xFF) * fx) >> 8;
+        Uint32 b = (((p10 >> shift) & 0xFF) * (256 - fx) + ((p11 >> shift) & 0xFF) * fx) >> 8;
+        res |= (((t * (256 - fy) + b * fy) >> 8) & 0xFF) << shift;
+    }
+    return res;
+}
+
+#ifdef SXUI_SSE2
+// Two pixels widened to 16-bit lanes, each with its own horizontal weight.
+static inline __m128i _bilinear_half(__m128i l0, __m128i r0, __m128i l1, __m128i r1,
+                                     __m128i wx, __m128i wy) {
+    const __m128i c256 = _mm_set1_epi16(256);
+    __m128i top = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(l0, _mm_sub_epi16(c256, wx)),
+                                               _mm_mullo_epi16(r0, wx)), 8);
+    __m128i bot = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(l1, _mm_sub_epi16(c256, wx)),
+                                               _mm_mullo_epi16(r1, wx)), 8);
+    return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(top, _mm_sub_epi16(c256, wy)),
+                                        _mm_mullo_epi16(bot, wy)), 8);
+}
+
+// Left and right taps of four pixels; each pair is adjacent in the row, so
+// one 64-bit load fetches both and two shuffles split them apart.
+static inline void _bilinear_taps(const Uint32* row, int x0, int x1, int x2, int x3,
+                                  __m128i* left, __m128i* right) {
+    __m128i a = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i*)(row + x0)),
+                                   _mm_loadl_epi64((const __m128i*)(row + x1)));
+    __m128i b = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i*)(row + x2)),
+                                   _mm_loadl_epi64((const __m128i*)(row + x3)));
+    a = _mm_shuffle_epi32(a, _MM_SHUFFLE(3, 1, 2, 0));
+    b = _mm_shuffle_epi32(b, _MM_SHUFFLE(3, 1, 2, 0));
+    *left = _mm_unpacklo_epi64(a, b);
+    *right = _mm_unpackhi_epi64(a, b);
+}
+#endif
+
+// Bilinear sample at 16.16 fixed-point source coordinates, clamped to the edges.
+static void _sample_bilinear_row(Uint32* out, const Uint8* src, int sw, int sh, int pitch,
+                                 int n, Sint64 u, Sint64 du, Sint64 v) {
+    if (v < 0) v = 0;
+    int y0 = (int)(v >> 16);
+    if (y0 > sh - 1) y0 = sh - 1;
+    int y1 = y0 + 1 < sh ? y0 + 1 : sh - 1;
+    Uint32 fy = (Uint32)((v >> 8) & 0xFF);
+    const Uint32* r0 = (const Uint32*)(src + (size_t)y0 * pitch);
+    const Uint32* r1 = (const Uint32*)(src + (size_t)y1 * pitch);
+    int i = 0;
+
+#ifdef SXUI_SSE2
+    // Four pixels per step while every tap lies inside the row; the clamped
+    // edges and the remainder fall through to the scalar loop. Positions are
+    // kept in 32-bit lanes, so the span has to stay below 2^31.
+    if (u + du * n < INT_MAX) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i wy = _mm_set1_epi16((short)fy);
+        const __m128i frac = _mm_set1_epi32(0xFF);
+        const __m128i step = _mm_set1_epi32((int)(du * 4));
+        // Pixels before the left edge clamp to column 0; skip them first.
+        while (i < n && u < 0) {
+            out[i++] = _bilinear_pixel(r0[0], r0[sw > 1], r1[0], r1[sw > 1], 0, fy);
+            u += du;
+        }
+        __m128i uu = _mm_setr_epi32((int)u, (int)(u + du), (int)(u + 2 * du), (int)(u + 3 * du));
+        for (; i + 4 <= n && ((u + 3 * du) >> 16) < sw - 1; i += 4, u += 4 * du) {
+            __m128i idx = _mm_srli_epi32(uu, 16);
+            int i0 = _mm_cvtsi128_si32(idx);
+            int i1 = _mm_cvtsi128_si32(_mm_shuffle_epi32(idx, 0x55));
+            int i2 = _mm_cvtsi128_si32(_mm_shuffle_epi32(idx, 0xAA));
+            int i3 = _mm_cvtsi128_si32(_mm_shuffle_epi32(idx, 0xFF));
+
+            __m128i f = _mm_and_si128(_mm_srli_epi32(uu, 8), frac);
+            f = _mm_packs_epi32(f, f);
+            f = _mm_unpacklo_epi16(f, f);
+            __m128i wx_lo = _mm_unpacklo_epi32(f, f);
+            __m128i wx_hi = _mm_unpackhi_epi32(f, f);
+
+            __m128i l0, rt0, l1, rt1;
+            _bilinear_taps(r0, i0, i1, i2, i3, &l0, &rt0);
+            _bilinear_taps(r1, i0, i1, i2, i3, &l1, &rt1);
+            __m128i lo = _bilinear_half(_mm_unpacklo_epi8(l0, zero), _mm_unpacklo_epi8(rt0, zero),
+                                        _mm_unpacklo_epi8(l1, zero), _mm_unpacklo_epi8(rt1, zero),
+                                        wx_lo, wy);
+            __m128i hi = _bilinear_half(_mm_unpackhi_epi8(l0, zero), _mm_unpackhi_epi8(rt0, zero),
+                                        _mm_unpackhi_epi8(l1, zero), _mm_unpackhi_epi8(rt1, zero),
+                                        wx_hi, wy);
+            _mm_storeu_si128((__m128i*)(out + i), _mm_packus_epi16(lo, hi));
+            uu = _mm_add_epi32(uu, step);
+        }
+    }
+#endif
+    for (; i < n; i++, u += du) {
+        Sint64 uc = u < 0 ? 0 : u;
+        int x0 = (int)(uc >> 16);
+        if (x0 > sw - 1) x0 = sw - 1;
+        int x1 = x0 + 1 < sw ? x0 + 1 : sw - 1;
+        Uint32 fx = (Uint32)((uc >> 8) & 0xFF);
+        out[i] = _bilinear_pixel(r0[x0], r0[x1], r1[x0], r1[x1], fx, fy);
+    }
 }
 
-UIElement* sxui_input(UIElement* p, const char* placeholder, int is_pass) {
-    UITextInput* i = calloc(1, sizeof(UITextInput));
-    init_base(&i->el, 0, 0, 0, 0, UI_INPUT);
-    if (is_pass) i->el.flags |= UI_FLAG_PASSWORD;
-    strncpy(i->placeholder, placeholder, INPUT_MAX - 1);
-    i->onFocusChanged = list_new();
-    i->onTextChanged = list_new();
-    i->onSubmit = list_new();
-    _add_to_parent(p, (UIElement*)i);
-    return (UIElement*)i;
+// Nearest sample along one source row at 16.16 fixed-point steps.
+static void _sample_nearest_row(Uint32* out, const Uint32* srow, int n, Sint64 u, Sint64 du) {
+    int i = 0;
+#ifdef SXUI_SSE2
+    // Four positions per step in 32-bit lanes; needs the whole span below 2^31.
+    if (u + du * n < INT_MAX) {
+        __m128i uu = _mm_setr_epi32((int)u, (int)(u + du), (int)(u + 2 * du), (int)(u + 3 * du));
+        const __m128i step = _mm_set1_epi32((int)(du * 4));
+        for (; i + 4 <= n; i += 4) {
+            __m128i idx = _mm_srli_epi32(uu, 16);
+            int i0 = _mm_cvtsi128_si32(idx);
+            int i1 = _mm_cvtsi128_si32(_mm_shuffle_epi32(idx, 0x55));
+            int i2 = _mm_cvtsi128_si32(_mm_shuffle_epi32(idx, 0xAA));
+            int i3 = _mm_cvtsi128_si32(_mm_shuffle_epi32(idx, 0xFF));
+            _mm_storeu_si128((__m128i*)(out + i),
+                             _mm_setr_epi32((int)srow[i0], (int)srow[i1], (int)srow[i2], (int)srow[i3]));
+            uu = _mm_add_epi32(uu, step);
+        }
+        u += du * i;
+    }
+#endif
+    for (; i < n; i++, u += du) out[i] = srow[u >> 16];
+}
+
+static void _canvas_blit(UICanvas* c, const Uint32* src_pixels, int sw, int sh, int pitch,
+                         SDL_Rect dst, int flags) {
+    UIElement* canvas = &c->el;
+    int x1 = dst.x < 0 ? 0 : dst.x;
+    int y1 = dst.y < 0 ? 0 : dst.y;
+    int x2 = dst.x + dst.w > canvas->w ? canvas->w : dst.x + dst.w;
+    int y2 = dst.y + dst.h > canvas->h ? canvas->h : dst.y + dst.h;
+    if (x1 >= x2 || y1 >= y2) return;
+
+    int n = x2 - x1;
+    int scaled = (dst.w != sw || dst.h != sh);
+    int blend = (flags & UI_BLIT_BLEND);
+    const Uint8* src = (const Uint8*)src_pixels;
+    Uint32* row = scaled ? malloc(n * sizeof(Uint32)) : NULL;
+    if (scaled && !row) return;
+
+    // 16.16 source step per destination pixel, sampled at pixel centres.
+    Sint64 du = ((Sint64)sw << 16) / dst.w;
+    Sint64 dv = ((Sint64)sh << 16) / dst.h;
+    // When upscaling, neighbouring output rows often sample the same source
+    // position; the row buffer is only refilled when that position changes.
+    Sint64 sampled = -1;
+
+    for (int y = y1; y < y2; y++) {
+        Uint32* out = &c->pixels[y * canvas->w + x1];
+        const Uint32* line;
+
+        if (!scaled) {
+            line = (const Uint32*)(src + (size_t)(y - dst.y) * pitch) + (x1 - dst.x);
+        } else if (flags & UI_BLIT_BILINEAR) {
+            Sint64 u = (x1 - dst.x) * du + du / 2 - 0x8000;
+            Sint64 v = (y - dst.y) * dv + dv / 2 - 0x8000;
+            if (v < 0) v = 0;
+            if ((v & ~0xFF) != sampled) _sample_bilinear_row(row, src, sw, sh, pitch, n, u, du, v);
+            sampled = v & ~0xFF;
+            line = row;
+        } else {
+            Sint64 u = (x1 - dst.x) * du + du / 2;
+            int sy = (int)(((y - dst.y) * dv + dv / 2) >> 16);
+            if (sy != sampled) _sample_nearest_row(row, (const Uint32*)(src + (size_t)sy * pitch), n, u, du);
+            sampled = sy;
+            line = row;
+        }
+
+        if (blend) _blend_row(out, line, n);
+        else memcpy(out, line, n * sizeof(Uint32));
+    }
+
+    free(row);
+    _canvas_mark_dirty(c, x1, y1, x2, y2);
 }
 
-UIElement* sxui_checkbox(UIElement* p, const char* label) {
-    UICheckBox* c = calloc(1, sizeof(UICheckBox));
-    init_base(&c->el, 0, 0, 0, 0, UI_CHECKBOX);
-    c->text = strdup(label);
-    c->onValueChanged = list_new();
-    _add_to_parent(p, (UIElement*)c);
-    return (UIElement*)c;
+void sxui_canvas_blit(UIElement* canvas, const Uint32* src_pixels, int sw, int sh, int pitch,
+                      const SDL_Rect* dst_rect, int flags) {
+    UICanvas* c = NULL;
+    CanvasTiles* t = _canvas_tiles(canvas);
+    if ((!t && !_canvas_get(canvas, &c)) || !src_pixels || sw <= 0 || sh <= 0) return;
+    if (pitch <= 0) pitch = sw * (int)sizeof(Uint32);
+    // Rows are read sw pixels wide; a shorter stride would run past the source.
+    if (pitch < sw * (int)sizeof(Uint32)) return;
+
+    SDL_Rect dst = dst_rect ? *dst_rect : (SDL_Rect){0, 0, sw, sh};
+    if (dst.w <= 0 || dst.h <= 0) return;
+    if (t) {
+        _tiled_blit(t, src_pixels, sw, sh, pitch, dst, flags);
+        return;
+    }
+
+    _canvas_blit(c, src_pixels, sw, sh, pitch, dst, flags);
+    int s = _ring_shift(c, dst.x, dst.x + dst.w - 1);
+    if (!s) return;
+    _ring_seam(c);
+    dst.x += s;
+    _canvas_blit(c, src_pixels, sw, sh, pitch, dst, flags);
+}
+
+// --- Double buffering ---
+// Three buffers rotate between the producer (back), the render thread (front)
+// and a shared "ready" slot. Publishing and picking up a frame are single
+// atomic exchanges, so neither side waits on the other and the renderer only
+// ever uploads a buffer the producer has finished with.
+
+#define CANVAS_BUFFER_INDEX 0x3
+#define CANVAS_BUFFER_FRESH 0x4
+
+void sxui_canvas_set_double_buffered(UIElement* canvas, int enabled) {
+    UICanvas* c;
+    if (!_canvas_get(canvas, &c)) return;
+    enabled = !!enabled;
+    int active = (c->buffers[0] != NULL);
+    if (enabled == active || (enabled && (c->layers || c->mapped || c->ring))) return;
+
+    size_t size = (size_t)canvas->w * canvas->h * sizeof(Uint32);
+
+    if (enabled) {
+        c->buffers[0] = c->pixels;
+        c->buffers[1] = malloc(size);
+        c->buffers[2] = malloc(size);
+        if (!c->buffers[1] || !c->buffers[2]) {
+            free(c->buffers[1]);
+            free(c->buffers[2]);
+            c->buffers[0] = c->buffers[1] = c->buffers[2] = NULL;
+            return;
+        }
+        memcpy(c->buffers[1], c->pixels, size);
+        memcpy(c->buffers[2], c->pixels, size);
+        c->back = 0;
+        c->front = 1;
+        SDL_AtomicSet(&c->ready, 2);
+        c->dirty = 0;
+        return;
+    }
+
+    // Keep the newest complete frame as the single buffer.
+    int ready = SDL_AtomicGet(&c->ready);
+    int keep = (ready & CANVAS_BUFFER_FRESH) ? (ready & CANVAS_BUFFER_INDEX) : c->front;
+    for (int i = 0; i < 3; i++) {
+        if (i != keep) free(c->buffers[i]);
+    }
+    c->pixels = c->buffers[keep];
+    c->buffers[0] = c->buffers[1] = c->buffers[2] = NULL;
+    _canvas_mark_dirty(c, 0, 0, canvas->w, canvas->h);
 }
 
-UIElement* sxui_slider(UIElement* p, float initial) {
-    UISlider* s = calloc(1, sizeof(UISlider));
-    init_base(&s->el, 0, 0, 0, 0, UI_SLIDER);
-    s->value = initial;
-    s->onValueChanged = list_new();
-    _add_to_parent(p, (UIElement*)s);
-    return (UIElement*)s;
+int sxui_canvas_is_double_buffered(UIElement* canvas) {
+    UICanvas* c;
+    if (!_canvas_get(canvas, &c)) return 0;
+    return c->buffers[0] != NULL;
 }
 
-<<<<<<< HEAD
-UIElement* sxui_dropdown(UIElement* parent, const char** options, int option_count, int default_index) {
-    UIDropdown* dd = calloc(1, sizeof(UIDropdown));
-    init_base(&dd->el, 0, 0, 0, 0, UI_DROPDOWN);
-    
-    dd->option_count = option_count;
-    dd->options = malloc(sizeof(char*) * option_count);
-    for (int i = 0; i < option_count; i++) {
-        dd->options[i] = strdup(options[i]);
-=======
-UIElement *sxui_dropdown(UIElement *parent, const char **options,
-                         int option_count, int default_index) {
-  UIDropdown *dd = calloc(1, sizeof(UIDropdown));
-  init_base(&dd->el, 0, 0, 0, 0, UI_DROPDOWN);
+void sxui_canvas_swap(UIElement* canvas) {
+    UICanvas* c;
+    if (!_canvas_get(canvas, &c) || !c->buffers[0]) return;
 
-  dd->option_count = option_count;
-  dd->options = malloc(sizeof(char *) * option_count);
-  for (int i = 0; i < option_count; i++) {
-    dd->options[i] = strdup(options[i]);
-  }
-  dd->selected_index =
-      (default_index >= 0 && default_index < option_count) ? default_index : 0;
-  dd->is_open = 0;
-  dd->el.z_index = DROPDOWN_Z_INDEX;
-  dd->onSelectionChanged = list_new();
+    int prev = SDL_AtomicSet(&c->ready, c->back | CANVAS_BUFFER_FRESH);
+    c->back = prev & CANVAS_BUFFER_INDEX;
+    c->pixels = c->buffers[c->back];
+}
 
-  _add_to_parent(parent, (UIElement *)dd);
-  return (UIElement *)dd;
+static void _canvas_acquire_front(UICanvas* c) {
+    if (!(SDL_AtomicGet(&c->ready) & CANVAS_BUFFER_FRESH)) return;
+
+    int prev = SDL_AtomicSet(&c->ready, c->front);
+    c->front = prev & CANVAS_BUFFER_INDEX;
+    if (c->texture) {
+        SDL_UpdateTexture(c->texture, NULL, c->buffers[c->front], c->pitch);
+    }
 }
 
-UIElement *sxui_canvas(UIElement *parent, int x, int y, int w, int h) {
-  UICanvas *c = calloc(1, sizeof(UICanvas));
-  init_base(&c->el, x, y, w, h, UI_CANVAS);
+// --- Layers ---
 
-  c->texture = SDL_CreateTexture(engine.renderer, SDL_PIXELFORMAT_RGBA8888,
-                                 SDL_TEXTUREACCESS_STREAMING, w, h);
-  c->pixels = calloc(w * h, sizeof(Uint32));
-  c->pitch = w * sizeof(Uint32);
+struct CanvasLayer {
+    char* name;
+    Uint32* pixels;
+    Uint8 opacity;
+    int visible;
+    UILayerBlend blend;
+};
 
-  _add_to_parent(parent, (UIElement *)c);
-  return (UIElement *)c;
+static inline Uint32 _div255(Uint32 v) {
+    v += 128;
+    return (v + (v >> 8)) >> 8;
 }
 
-void _delete_element_recursive(UIElement *el) {
-  if (!el)
-    return;
+static inline Uint32 _layer_channel(Uint32 s, Uint32 d, UILayerBlend mode) {
+    switch (mode) {
+        case UI_LAYER_BLEND_ADD: return s + d > 255 ? 255 : s + d;
+        case UI_LAYER_BLEND_MULTIPLY: return _div255(s * d);
+        case UI_LAYER_BLEND_SCREEN: return s + d - _div255(s * d);
+        default: return s;
+    }
+}
 
-  for (size_t i = 0; i < list_length(el->children); i++) {
-    _delete_element_recursive(list_get(el->children, i));
-  }
+static inline Uint32 _composite_pixel(Uint32 dst, Uint32 src, Uint32 opacity, UILayerBlend mode) {
+    Uint32 a = _div255((src & 0xFF) * opacity);
+    if (a == 0) return dst;
+    Uint32 out = _div255(255 * a + (dst & 0xFF) * (255 - a));
+    for (int shift = 8; shift < 32; shift += 8) {
+        Uint32 sc = (src >> shift) & 0xFF, dc = (dst >> shift) & 0xFF;
+        Uint32 b = _layer_channel(sc, dc, mode);
+        out |= _div255(b * a + dc * (255 - a)) << shift;
+    }
+    return out;
+}
+
+#ifdef SXUI_SSE2
+static inline __m128i _div255_epi16(__m128i v) {
+    v = _mm_add_epi16(v, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(v, _mm_srli_epi16(v, 8)), 8);
+}
+
+// Two pixels widened to 16-bit lanes; the alpha lane of each is forced to 255
+// so the shared formula below reproduces "over" for alpha.
+static inline __m128i _composite_half(__m128i s, __m128i d, __m128i a, UILayerBlend mode) {
+    const __m128i c255 = _mm_set1_epi16(255);
+    const __m128i alpha_mask = _mm_set_epi16(0, 0, 0, -1, 0, 0, 0, -1);
+    __m128i b;
+    switch (mode) {
+        case UI_LAYER_BLEND_ADD: b = _mm_min_epi16(_mm_add_epi16(s, d), c255); break;
+        case UI_LAYER_BLEND_MULTIPLY: b = _div255_epi16(_mm_mullo_epi16(s, d)); break;
+        case UI_LAYER_BLEND_SCREEN:
+            b = _mm_sub_epi16(_mm_add_epi16(s, d), _div255_epi16(_mm_mullo_epi16(s, d)));
+            break;
+        default: b = s; break;
+    }
+    b = _mm_or_si128(_mm_andnot_si128(alpha_mask, b), _mm_and_si128(alpha_mask, c255));
+    return _div255_epi16(_mm_add_epi16(_mm_mullo_epi16(b, a),
+                                       _mm_mullo_epi16(d, _mm_sub_epi16(c255, a))));
+}
+#endif
 
-  list_free(el->children);
-  list_free(el->onMouseEnter);
-  list_free(el->onMouseLeave);
-  list_free(el->onMouseClick); // Free the new list
+static void _composite_row(Uint32* dst, const Uint32* src, int n, Uint32 opacity, UILayerBlend mode) {
+    if (mode == UI_LAYER_BLEND_NORMAL && opacity == 255) {
+        _blend_row(dst, src, n);
+        return;
+    }
+    int i = 0;
+#ifdef SXUI_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i op = _mm_set1_epi16((short)opacity);
+    for (; i + 4 <= n; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i s_lo = _mm_unpacklo_epi8(s, zero), s_hi = _mm_unpackhi_epi8(s, zero);
+        __m128i d_lo = _mm_unpacklo_epi8(d, zero), d_hi = _mm_unpackhi_epi8(d, zero);
+
+        __m128i a_lo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s_lo, 0x00), 0x00);
+        __m128i a_hi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s_hi, 0x00), 0x00);
+        a_lo = _div255_epi16(_mm_mullo_epi16(a_lo, op));
+        a_hi = _div255_epi16(_mm_mullo_epi16(a_hi, op));
+
+        __m128i lo = _composite_half(s_lo, d_lo, a_lo, mode);
+        __m128i hi = _composite_half(s_hi, d_hi, a_hi, mode);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; i < n; i++) dst[i] = _composite_pixel(dst[i], src[i], opacity, mode);
+}
+
+// Rebuilds the composite for the damaged rectangle only; layers outside it
+// are never read, so a static background costs nothing per frame.
+static void _canvas_composite(UICanvas* c, const SDL_Rect* r) {
+    int w = c->el.w;
+    for (int y = r->y; y < r->y + r->h; y++) {
+        Uint32* dst = &c->composite[y * w + r->x];
+        int first = 1;
+        for (int i = 0; i < c->layer_count; i++) {
+            CanvasLayer* l = &c->layers[i];
+            if (!l->visible || l->opacity == 0) continue;
+            const Uint32* src = &l->pixels[y * w + r->x];
+            if (first) {
+                // Nothing underneath yet: the layer is copied, not blended.
+                if (l->opacity == 255) {
+                    memcpy(dst, src, r->w * sizeof(Uint32));
+                } else {
+                    for (int x = 0; x < r->w; x++) {
+                        dst[x] = (src[x] & 0xFFFFFF00) | _div255((src[x] & 0xFF) * l->opacity);
+                    }
+                }
+                first = 0;
+                continue;
+            }
+            _composite_row(dst, src, r->w, l->opacity, l->blend);
+        }
+        if (first) memset(dst, 0, r->w * sizeof(Uint32));
+    }
+}
 
-  if (el->effects.gradient.stops) {
-    for (size_t i = 0; i < list_length(el->effects.gradient.stops); i++) {
-      free(list_get(el->effects.gradient.stops, i));
->>>>>>> 410878f (feat: Add new pages and enhance input handling)
+static void _canvas_resize_layers(UICanvas* c) {
+    if (!c->layers) return;
+    size_t count = (size_t)c->el.w * c->el.h;
+    for (int i = 0; i < c->layer_count; i++) {
+        if (i == c->active_layer) {
+            c->layers[i].pixels = c->pixels;
+            continue;
+        }
+        free(c->layers[i].pixels);
+        c->layers[i].pixels = calloc(count, sizeof(Uint32));
+    }
+    free(c->composite);
+    c->composite = calloc(count, sizeof(Uint32));
+    _canvas_mark_dirty(c, 0, 0, c->el.w, c->el.h);
+}
+
+static void _canvas_free_layers(UICanvas* c) {
+    if (!c->layers) return;
+    for (int i = 0; i < c->layer_count; i++) {
+        if (c->layers[i].pixels != c->pixels) free(c->layers[i].pixels);
+        free(c->layers[i].name);
+    }
+    free(c->layers);
+    free(c->composite);
+    c->layers = NULL;
+    c->composite = NULL;
+    c->layer_count = c->layer_cap = c->active_layer = 0;
+}
+
+static CanvasLayer* _canvas_layer(UIElement* canvas, int layer, UICanvas** out) {
+    UICanvas* c;
+    if (!_canvas_get(canvas, &c) || layer < 0 || layer >= c->layer_count) return NULL;
+    if (out) *out = c;
+    return &c->layers[layer];
+}
+
+int sxui_canvas_add_layer(UIElement* canvas, const char* name) {
+    UICanvas* c;
+    if (!_canvas_get(canvas, &c) || c->buffers[0] || c->mapped || c->ring) return -1;
+    size_t count = (size_t)canvas->w * canvas->h;
+
+    // The first extra layer turns the existing pixels into layer 0.
+    if (!c->layers) {
+        char* base = strdup("background");
+        c->composite = malloc(count * sizeof(Uint32));
+        c->layers = calloc(4, sizeof(CanvasLayer));
+        if (!base || !c->composite || !c->layers) {
+            free(base);
+            free(c->composite);
+            free(c->layers);
+            c->composite = NULL;
+            c->layers = NULL;
+            return -1;
+        }
+        c->layer_cap = 4;
+        c->layers[0] = (CanvasLayer){base, c->pixels, 255, 1, UI_LAYER_BLEND_NORMAL};
+        c->layer_count = 1;
+        c->active_layer = 0;
+        _canvas_damage(c, 0, 0, canvas->w, canvas->h);
+    }
+
+    if (c->layer_count == c->layer_cap) {
+        CanvasLayer* layers = realloc(c->layers, c->layer_cap * 2 * sizeof(CanvasLayer));
+        if (!layers) return -1;
+        c->layers = layers;
+        c->layer_cap *= 2;
     }
-    dd->selected_index = (default_index >= 0 && default_index < option_count) ? default_index : 0;
-    dd->is_open = 0;
-    dd->el.z_index = DROPDOWN_Z_INDEX;
-    dd->onSelectionChanged = list_new();
-    
-    _add_to_parent(parent, (UIElement*)dd);
-    return (UIElement*)dd;
+    char* copy = strdup(name ? name : "");
+    Uint32* pixels = copy ? calloc(count, sizeof(Uint32)) : NULL;
+    if (!pixels) {
+        free(copy);
+        return -1;
+    }
+    c->layers[c->layer_count] = (CanvasLayer){copy, pixels, 255, 1, UI_LAYER_BLEND_NORMAL};
+    return c->layer_count++;
 }
 
-UIElement* sxui_canvas(UIElement* parent, int x, int y, int w, int h) {
-    UICanvas* c = calloc(1, sizeof(UICanvas));
-    init_base(&c->el, x, y, w, h, UI_CANVAS);
-    
-    c->texture = SDL_CreateTexture(engine.renderer, SDL_PIXELFORMAT_RGBA8888,
-                                    SDL_TEXTUREACCESS_STREAMING, w, h);
-    c->pixels = calloc(w * h, sizeof(Uint32));
-    c->pitch = w * sizeof(Uint32);
-    
-    _add_to_parent(parent, (UIElement*)c);
-    return (UIElement*)c;
+int sxui_canvas_find_layer(UIElement* canvas, const char* name) {
+    UICanvas* c;
+    if (!_canvas_get(canvas, &c) || !name) return -1;
+    for (int i = 0; i < c->layer_count; i++) {
+        if (strcmp(c->layers[i].name, name) == 0) return i;
+    }
+    return -1;
 }
 
-<<<<<<< HEAD
-void _delete_element_recursive(UIElement* el) {
-    if (!el) return;
-    
-=======
-void sxui_delete(UIElement *element) {
-  if (!element)
-    return;
+int sxui_canvas_get_layer_count(UIElement* canvas) {
+    UICanvas* c;
+    if (!_canvas_get(canvas, &c)) return 0;
+    return c->layers ? c->layer_count : 1;
+}
 
-  if (element == engine.focused) {
-    engine.focused = NULL;
-  }
-  if (element == engine.dragging_el) {
-    engine.dragging_el = NULL;
-  }
+void sxui_canvas_select_layer(UIElement* canvas, int layer) {
+    UICanvas* c;
+    if (!_canvas_layer(canvas, layer, &c)) return;
+    c->active_layer = layer;
+    c->pixels = c->layers[layer].pixels;
+}
 
-  if (element->parent) {
-    list_remove(element->parent->children, element);
-    if (element->parent->type == UI_FRAME) {
-      sx_update_layout((UIFrame *)element->parent);
-    }
-  } else {
-    list_remove(engine.root, element);
-  }
+void sxui_canvas_set_layer_opacity(UIElement* canvas, int layer, Uint8 opacity) {
+    UICanvas* c;
+    CanvasLayer* l = _canvas_layer(canvas, layer, &c);
+    if (!l || l->opacity == opacity) return;
+    l->opacity = opacity;
+    _canvas_damage(c, 0, 0, canvas->w, canvas->h);
+}
 
-  _delete_element_recursive(element);
+void sxui_canvas_set_layer_visible(UIElement* canvas, int layer, int visible) {
+    UICanvas* c;
+    CanvasLayer* l = _canvas_layer(canvas, layer, &c);
+    if (!l || l->visible == !!visible) return;
+    l->visible = !!visible;
+    _canvas_damage(c, 0, 0, canvas->w, canvas->h);
 }
 
-void sxui_set_position(UIElement *el, int x, int y) {
-  if (el) {
-    el->x = x;
-    el->y = y;
-  }
+void sxui_canvas_set_layer_blend(UIElement* canvas, int layer, UILayerBlend blend) {
+    UICanvas* c;
+    CanvasLayer* l = _canvas_layer(canvas, layer, &c);
+    if (!l || l->blend == blend) return;
+    l->blend = blend;
+    _canvas_damage(c, 0, 0, canvas->w, canvas->h);
 }
 
-void sxui_set_size(UIElement *el, int w, int h) {
-  if (el) {
-    el->w = w;
-    el->h = h;
+// --- Sprites ---
 
-    if (el->type == UI_CANVAS) {
-      UICanvas *c = (UICanvas *)el;
-      if (c->texture)
-        SDL_DestroyTexture(c->texture);
-      if (c->pixels)
-        free(c->pixels);
+struct UISprite {
+    char* path;
+    int w, h;
+    Uint32* pixels;
+};
 
-      c->texture = SDL_CreateTexture(engine.renderer, SDL_PIXELFORMAT_RGBA8888,
-                                     SDL_TEXTUREACCESS_STREAMING, w, h);
-      c->pixels = calloc(w * h, sizeof(Uint32));
-      c->pitch = w * sizeof(Uint32);
+static list* sprite_cache = NULL;
+
+UISprite* sxui_sprite_load_bmp(const char* path) {
+    if (!path) return NULL;
+
+    if (sprite_cache) {
+        for (size_t i = 0; i < list_length(sprite_cache); i++) {
+            UISprite* s = list_get(sprite_cache, i);
+            if (strcmp(s->path, path) == 0) return s;
+        }
     }
-  }
-}
 
-static void sxui_get_abs_pos(UIElement *el, int *x, int *y) {
-  if (!el)
-    return;
-  int wx = el->x;
-  int wy = el->y;
-  UIElement *p = el->parent;
-  while (p) {
-    wx += p->x;
-    wy += p->y;
-    if (p->type == UI_FRAME) {
-      wy -= ((UIFrame *)p)->scroll_y;
+    SDL_Surface* loaded = SDL_LoadBMP(path);
+    if (!loaded) {
+        printf("Warning: Could not load sprite %s: %s\n", path, SDL_GetError());
+        return NULL;
     }
-    p = p->parent;
-  }
-  if (x)
-    *x = wx;
-  if (y)
-    *y = wy;
+    SDL_Surface* conv = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA8888, 0);
+    SDL_FreeSurface(loaded);
+    if (!conv) return NULL;
+
+    UISprite* s = calloc(1, sizeof(UISprite));
+    if (s) {
+        s->path = strdup(path);
+        s->pixels = malloc((size_t)conv->w * conv->h * sizeof(Uint32));
+    }
+    if (!s || !s->path || !s->pixels) {
+        if (s) {
+            free(s->path);
+            free(s->pixels);
+            free(s);
+        }
+        SDL_FreeSurface(conv);
+        return NULL;
+    }
+    s->w = conv->w;
+    s->h = conv->h;
+
+    SDL_LockSurface(conv);
+    for (int y = 0; y < s->h; y++) {
+        memcpy(&s->pixels[y * s->w], (Uint8*)conv->pixels + (size_t)y * conv->pitch,
+               s->w * sizeof(Uint32));
+    }
+    SDL_UnlockSurface(conv);
+    SDL_FreeSurface(conv);
+
+    if (!sprite_cache) sprite_cache = list_new();
+    list_add(sprite_cache, s);
+    return s;
 }
 
-// --- Utility Getters ---
+int sxui_sprite_get_width(UISprite* sprite) {
+    return sprite ? sprite->w : 0;
+}
 
-int sxui_get_width(UIElement *el) { return el ? el->w : 0; }
-int sxui_get_height(UIElement *el) { return el ? el->h : 0; }
+int sxui_sprite_get_height(UISprite* sprite) {
+    return sprite ? sprite->h : 0;
+}
 
-void sxui_get_mouse_pos(int *x, int *y) {
-  if (x)
-    *x = engine.mouse_x;
-  if (y)
-    *y = engine.mouse_y;
+void sxui_canvas_draw_sprite(UIElement* canvas, UISprite* sprite, const SDL_Rect* dst_rect, int flags) {
+    if (!sprite) return;
+    sxui_canvas_blit(canvas, sprite->pixels, sprite->w, sprite->h,
+                     sprite->w * (int)sizeof(Uint32), dst_rect, flags);
 }
 
-int sxui_get_mouse_x(void) { return engine.mouse_x; }
-int sxui_get_mouse_y(void) { return engine.mouse_y; }
+void sxui_sprite_cache_clear(void) {
+    if (!sprite_cache) return;
+    for (size_t i = 0; i < list_length(sprite_cache); i++) {
+        UISprite* s = list_get(sprite_cache, i);
+        free(s->path);
+        free(s->pixels);
+        free(s);
+    }
+    list_free(sprite_cache);
+    sprite_cache = NULL;
+}
 
-int sxui_is_mouse_button_down(int button) {
-  // SDL_BUTTON_LEFT is 1, SDL_BUTTON_RIGHT is 3, etc.
-  // Our internal array is 0-indexed.
-  int btn_idx = button - 1;
-  if (btn_idx >= 0 && btn_idx < 8)
-    return engine.mouse_buttons[btn_idx];
-  return 0;
+// --- Text ---
+// Glyphs are rasterized once per font as 8-bit coverage masks and blended
+// straight into the canvas pixels, so drawing text costs no TTF call and no
+// texture. Text is Latin-1 like _draw_text.
+
+typedef struct {
+    Uint8* coverage;
+    int w, h;
+    int advance;
+    int loaded;
+} CanvasGlyph;
+
+typedef struct {
+    TTF_Font* font;
+    CanvasGlyph glyphs[256];
+} GlyphCache;
+
+static list* glyph_caches = NULL;
+
+static void _glyph_cache_free(GlyphCache* gc) {
+    for (int i = 0; i < 256; i++) free(gc->glyphs[i].coverage);
+    free(gc);
 }
 
-int sxui_is_mouse_button_up(int button) {
-  // SDL_BUTTON_LEFT is 1, SDL_BUTTON_RIGHT is 3, etc.
-  // Our internal array is 0-indexed.
-  int btn_idx = button - 1;
-  if (btn_idx >= 0 && btn_idx < 8)
-    return !engine.mouse_buttons[btn_idx];
-  return 0;
+// Must run before a font is closed: a later TTF_OpenFont may reuse the
+// address and would otherwise pick up the old glyphs.
+static void _glyph_cache_drop(TTF_Font* font) {
+    if (!glyph_caches) return;
+    for (size_t i = 0; i < list_length(glyph_caches); i++) {
+        GlyphCache* gc = list_get(glyph_caches, i);
+        if (gc->font == font) {
+            list_remove_at(glyph_caches, i);
+            _glyph_cache_free(gc);
+            return;
+        }
+    }
 }
 
-int sxui_is_mouse_button_pressed(int button) {
-  // SDL_BUTTON_LEFT is 1, SDL_BUTTON_RIGHT is 3, etc.
-  // Our internal array is 0-indexed.
-  int btn_idx = button - 1;
-  if (btn_idx >= 0 && btn_idx < 8)
-    return engine.mouse_buttons[btn_idx] && !engine.last_mouse_buttons[btn_idx];
-  return 0;
+static GlyphCache* _glyph_cache_get(TTF_Font* font) {
+    if (!glyph_caches) glyph_caches = list_new();
+    for (size_t i = 0; i < list_length(glyph_caches); i++) {
+        GlyphCache* gc = list_get(glyph_caches, i);
+        if (gc->font == font) return gc;
+    }
+    GlyphCache* gc = calloc(1, sizeof(GlyphCache));
+    if (!gc) return NULL;
+    gc->font = font;
+    list_add(glyph_caches, gc);
+    return gc;
+}
+
+// Shaded rendering against a black background with a white foreground gives
+// an 8-bit surface whose palette index is the coverage.
+static CanvasGlyph* _glyph_get(GlyphCache* gc, Uint8 ch) {
+    CanvasGlyph* g = &gc->glyphs[ch];
+    if (g->loaded) return g;
+    g->loaded = 1;
+    if (TTF_GlyphMetrics(gc->font, ch, NULL, NULL, NULL, NULL, &g->advance) != 0) g->advance = 0;
+
+    SDL_Color fg = {255, 255, 255, 255}, bg = {0, 0, 0, 255};
+    SDL_Surface* s = TTF_RenderGlyph_Shaded(gc->font, ch, fg, bg);
+    if (!s) return g;
+    g->coverage = malloc((size_t)s->w * s->h);
+    if (g->coverage) {
+        g->w = s->w;
+        g->h = s->h;
+        SDL_LockSurface(s);
+        for (int y = 0; y < s->h; y++)
+            memcpy(&g->coverage[y * s->w], (Uint8*)s->pixels + (size_t)y * s->pitch, s->w);
+        SDL_UnlockSurface(s);
+    }
+    SDL_FreeSurface(s);
+    return g;
+}
+
+static void _glyph_blend(UICanvas* c, const CanvasGlyph* g, int gx, int gy, Uint32 color) {
+    int x1 = gx < 0 ? -gx : 0, y1 = gy < 0 ? -gy : 0;
+    int x2 = g->w, y2 = g->h;
+    if (gx + x2 > c->el.w) x2 = c->el.w - gx;
+    if (gy + y2 > c->el.h) y2 = c->el.h - gy;
+    Uint32 alpha = color & 0xFF, rgb = color & 0xFFFFFF00;
+
+    for (int y = y1; y < y2; y++) {
+        const Uint8* cov = &g->coverage[y * g->w];
+        Uint32* dst = &c->pixels[(gy + y) * c->el.w + gx];
+        for (int x = x1; x < x2; x++) {
+            Uint32 v = cov[x];
+            if (!v) continue;
+            if (v == 255 && alpha == 255) {
+                dst[x] = color;
+                continue;
+            }
+            Uint32 a = (alpha * v + 127) / 255;
+            if (a) dst[x] = _blend_pixel(dst[x], rgb | a);
+        }
+    }
 }
 
-int sxui_is_mouse_button_released(int button) {
-  // SDL_BUTTON_LEFT is 1, SDL_BUTTON_RIGHT is 3, etc.
-  // Our internal array is 0-indexed.
-  int btn_idx = button - 1;
-  if (btn_idx >= 0 && btn_idx < 8)
-    return !engine.mouse_buttons[btn_idx] && engine.last_mouse_buttons[btn_idx];
-  return 0;
+// Returns the horizontal extent of the inked glyphs in x1/x2 (x2 exclusive).
+static void _canvas_text(UICanvas* c, GlyphCache* gc, TTF_Font* font, int x, int y,
+                         const char* text, Uint32 color, int* x1, int* x2) {
+    int pen_x = x, pen_y = y, line = TTF_FontLineSkip(font);
+    int bx1 = INT_MAX, by1 = INT_MAX, bx2 = INT_MIN, by2 = INT_MIN;
+    Uint8 prev = 0;
+    for (const Uint8* p = (const Uint8*)text; *p; p++) {
+        if (*p == '\n') {
+            pen_x = x;
+            pen_y += line;
+            prev = 0;
+            continue;
+        }
+        CanvasGlyph* g = _glyph_get(gc, *p);
+        if (prev) pen_x += TTF_GetFontKerningSizeGlyphs(font, prev, *p);
+        prev = *p;
+        if (g->coverage) {
+            _glyph_blend(c, g, pen_x, pen_y, color);
+            if (pen_x < bx1) bx1 = pen_x;
+            if (pen_y < by1) by1 = pen_y;
+            if (pen_x + g->w > bx2) bx2 = pen_x + g->w;
+            if (pen_y + g->h > by2) by2 = pen_y + g->h;
+        }
+        pen_x += g->advance;
+    }
+    if (bx1 < bx2) _canvas_mark_dirty(c, bx1, by1, bx2, by2);
+    *x1 = bx1;
+    *x2 = bx2;
+}
+
+void sxui_canvas_draw_text(UIElement* canvas, int x, int y, const char* text, Uint32 color, TTF_Font* font) {
+    UICanvas* c;
+    if (!_canvas_get(canvas, &c) || !text || !*text) return;
+    if (!font) font = _get_active_font();
+    if (!font) return;
+    GlyphCache* gc = _glyph_cache_get(font);
+    if (!gc) return;
+
+    int x1, x2;
+    _canvas_text(c, gc, font, x, y, text, color, &x1, &x2);
+    int s = x1 < x2 ? _ring_shift(c, x1, x2 - 1) : 0;
+    if (!s) return;
+    _ring_seam(c);
+    _canvas_text(c, gc, font, x + s, y, text, color, &x1, &x2);
 }
 
-int sxui_is_key_down(int scancode) {
-  if (scancode >= 0 && scancode < 512)
-    return engine.keyboard_state[scancode];
-  return 0;
+void sxui_glyph_cache_clear(void) {
+    if (!glyph_caches) return;
+    for (size_t i = 0; i < list_length(glyph_caches); i++) _glyph_cache_free(list_get(glyph_caches, i));
+    list_free(glyph_caches);
+    glyph_caches = NULL;
 }
 
-int sxui_is_key_pressed(int scancode) {
-  if (scancode >= 0 && scancode < 512)
-    return engine.keyboard_state[scancode] &&
-           !engine.last_keyboard_state[scancode];
-  return 0;
+// --- Paths ---
+
+#define PATH_SUBSAMPLES 4
+#define PATH_TOLERANCE 0.2f
+#define PATH_MAX_SEGMENTS 256
+#define PATH_FULL_COVERAGE (256 * PATH_SUBSAMPLES)
+
+struct UIPath {
+    float* pts;
+    int count, cap;
+    int* starts;
+    int contours, contour_cap;
+    float cur_x, cur_y;
+    int open;
+};
+
+typedef struct {
+    float x0, y0, x1, y1;
+    float dxdy;
+    int dir;
+    int sub;
+} PathEdge;
+
+UIPath* sxui_path_new(void) {
+    return calloc(1, sizeof(UIPath));
+}
+
+void sxui_path_free(UIPath* path) {
+    if (!path) return;
+    free(path->pts);
+    free(path->starts);
+    free(path);
+}
+
+void sxui_path_reset(UIPath* path) {
+    if (!path) return;
+    path->count = 0;
+    path->contours = 0;
+    path->open = 0;
+    path->cur_x = path->cur_y = 0;
+}
+
+static void _path_push(UIPath* p, float x, float y) {
+    if (p->count == p->cap) {
+        int cap = p->cap ? p->cap * 2 : 64;
+        float* pts = realloc(p->pts, cap * 2 * sizeof(float));
+        if (!pts) return;
+        p->pts = pts;
+        p->cap = cap;
+    }
+    p->pts[p->count * 2] = x;
+    p->pts[p->count * 2 + 1] = y;
+    p->count++;
+    p->cur_x = x;
+    p->cur_y = y;
+}
+
+static void _path_begin(UIPath* p, float x, float y) {
+    if (p->contours == p->contour_cap) {
+        int cap = p->contour_cap ? p->contour_cap * 2 : 8;
+        int* starts = realloc(p->starts, cap * sizeof(int));
+        if (!starts) return;
+        p->starts = starts;
+        p->contour_cap = cap;
+    }
+    p->starts[p->contours++] = p->count;
+    p->open = 1;
+    _path_push(p, x, y);
 }
 
-int sxui_is_key_released(int scancode) {
-  if (scancode >= 0 && scancode < 512)
-    return !engine.keyboard_state[scancode] &&
-           engine.last_keyboard_state[scancode];
-  return 0;
+void sxui_path_move_to(UIPath* path, float x, float y) {
+    if (path) _path_begin(path, x, y);
 }
 
-void sxui_get_window_size(int *w, int *h) {
-  if (w)
-    *w = engine.window_width;
-  if (h)
-    *h = engine.window_height;
+void sxui_path_line_to(UIPath* path, float x, float y) {
+    if (!path) return;
+    if (!path->open) _path_begin(path, path->cur_x, path->cur_y);
+    _path_push(path, x, y);
 }
 
-int sxui_get_window_width(void) { return engine.window_width; }
-int sxui_get_window_height(void) { return engine.window_height; }
+static int _path_segments(float dd) {
+    int n = (int)ceilf(sqrtf(dd / PATH_TOLERANCE));
+    if (n < 1) n = 1;
+    if (n > PATH_MAX_SEGMENTS) n = PATH_MAX_SEGMENTS;
+    return n;
+}
 
-void sxui_quit(void) { engine.running = 0; }
+void sxui_path_quad_to(UIPath* path, float cx, float cy, float x, float y) {
+    if (!path) return;
+    if (!path->open) _path_begin(path, path->cur_x, path->cur_y);
 
-// --- Event Binding ---
+    float x0 = path->cur_x, y0 = path->cur_y;
+    float ddx = x0 - 2 * cx + x, ddy = y0 - 2 * cy + y;
+    int n = _path_segments(sqrtf(ddx * ddx + ddy * ddy) / 8.0f);
 
-UIConnection sxui_on_mouse_click(UIElement *el, MouseClickCallback cb) {
-  if (el && cb)
-    return bind_event(el->onMouseClick, cb);
-  UIConnection empty = {0, NULL};
-  return empty;
+    for (int i = 1; i <= n; i++) {
+        float t = (float)i / n, mt = 1.0f - t;
+        _path_push(path, mt * mt * x0 + 2 * mt * t * cx + t * t * x,
+                         mt * mt * y0 + 2 * mt * t * cy + t * t * y);
+    }
 }
 
-const char *sxui_get_scancode_name(int scancode) {
-  return SDL_GetScancodeName((SDL_Scancode)scancode);
-}
+void sxui_path_cubic_to(UIPath* path, float c1x, float c1y, float c2x, float c2y, float x, float y) {
+    if (!path) return;
+    if (!path->open) _path_begin(path, path->cur_x, path->cur_y);
 
-// --- Element Properties ---
+    float x0 = path->cur_x, y0 = path->cur_y;
+    float ax = x0 - 2 * c1x + c2x, ay = y0 - 2 * c1y + c2y;
+    float bx = c1x - 2 * c2x + x, by = c1y - 2 * c2y + y;
+    float dd = fmaxf(ax * ax + ay * ay, bx * bx + by * by);
+    int n = _path_segments(sqrtf(dd) * 0.75f);
 
-void sxui_set_visible(UIElement *el, int visible) {
-  if (el) {
-    if (visible)
-      el->flags &= ~UI_FLAG_HIDDEN;
-    else
-      el->flags |= UI_FLAG_HIDDEN;
+    for (int i = 1; i <= n; i++) {
+        float t = (float)i / n, mt = 1.0f - t;
+        float a = mt * mt * mt, b = 3 * mt * mt * t, c = 3 * mt * t * t, d = t * t * t;
+        _path_push(path, a * x0 + b * c1x + c * c2x + d * x,
+                         a * y0 + b * c1y + c * c2y + d * y);
+    }
+}
 
->>>>>>> 410878f (feat: Add new pages and enhance input handling)
-    for (size_t i = 0; i < list_length(el->children); i++) {
-        _delete_element_recursive(list_get(el->children, i));
+void sxui_path_close(UIPath* path) {
+    if (!path || !path->open) return;
+    int start = path->starts[path->contours - 1];
+    path->cur_x = path->pts[start * 2];
+    path->cur_y = path->pts[start * 2 + 1];
+    path->open = 0;
+}
+
+// Orders edges by the first sub-scanline that samples them, with a counting
+// sort over the canvas's sub-scanlines instead of a comparison sort. Edges
+// starting below the canvas share the last bucket and are never activated.
+static int _path_sort_edges(PathEdge* edges, int n, int h) {
+    int subs = h * PATH_SUBSAMPLES;
+    int* start = calloc(subs + 2, sizeof(int));
+    PathEdge* sorted = malloc(n * sizeof(PathEdge));
+    if (!start || !sorted) {
+        free(start);
+        free(sorted);
+        return 0;
     }
-    
-    list_free(el->children);
-    list_free(el->onMouseEnter);
-    list_free(el->onMouseLeave);
-    
-    if (el->effects.gradient.stops) {
-        for (size_t i = 0; i < list_length(el->effects.gradient.stops); i++) {
-            free(list_get(el->effects.gradient.stops, i));
-        }
-        list_free(el->effects.gradient.stops);
+    for (int i = 0; i < n; i++) {
+        float g = ceilf(edges[i].y0 * PATH_SUBSAMPLES - 0.5f);
+        edges[i].sub = g < 0 ? 0 : (g > subs ? subs : (int)g);
+        start[edges[i].sub + 1]++;
     }
-    
-    switch (el->type) {
-        case UI_BUTTON:
-            free(((UIButton*)el)->text);
-            list_free(((UIButton*)el)->onClick);
-            break;
-        case UI_LABEL:
-            free(((UILabel*)el)->text);
-            break;
-        case UI_INPUT:
-            list_free(((UITextInput*)el)->onFocusChanged);
-            list_free(((UITextInput*)el)->onTextChanged);
-            list_free(((UITextInput*)el)->onSubmit);
-            break;
-        case UI_CHECKBOX:
-            free(((UICheckBox*)el)->text);
-            list_free(((UICheckBox*)el)->onValueChanged);
-            break;
-        case UI_SLIDER:
-            list_free(((UISlider*)el)->onValueChanged);
-            break;
-        case UI_DROPDOWN:
-            for (int i = 0; i < ((UIDropdown*)el)->option_count; i++) {
-                free(((UIDropdown*)el)->options[i]);
-            }
-            free(((UIDropdown*)el)->options);
-            list_free(((UIDropdown*)el)->onSelectionChanged);
-            break;
-        case UI_CANVAS:
-            if (((UICanvas*)el)->texture) {
-                SDL_DestroyTexture(((UICanvas*)el)->texture);
-            }
-            free(((UICanvas*)el)->pixels);
-            break;
-        default:
-            break;
+    for (int i = 0; i <= subs; i++) start[i + 1] += start[i];
+    for (int i = 0; i < n; i++) sorted[start[edges[i].sub]++] = edges[i];
+    memcpy(edges, sorted, n * sizeof(PathEdge));
+    free(start);
+    free(sorted);
+    return 1;
+}
+
+// Coverage is accumulated in 1/256ths of a pixel per sub-scanline. Span ends
+// go straight into cov[]; span interiors go through the acc[] difference
+// array, so a span costs O(1) no matter how wide it is. Every column a span
+// writes is also flagged in the bits[] mask; between two flagged columns the
+// coverage is constant, so compositing walks the mask 64 columns at a time
+// and blends each gap as one run instead of visiting every pixel of the row.
+typedef struct {
+    int* cov;
+    int* acc;
+    Uint64* bits;
+    int w;
+    int x0, x1;
+} PathRow;
+
+static inline int _path_ctz(Uint64 v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(v);
+#else
+    int n = 0;
+    while (!(v & 1)) { v >>= 1; n++; }
+    return n;
+#endif
+}
+
+static inline void _path_flag(PathRow* r, int x) {
+    r->bits[x >> 6] |= (Uint64)1 << (x & 63);
+}
+
+static void _path_add_span(PathRow* r, float xa, float xb) {
+    if (xa < 0) xa = 0;
+    if (xb > r->w) xb = (float)r->w;
+    if (xa >= xb) return;
+
+    int fa = (int)(xa * 256.0f), fb = (int)(xb * 256.0f);
+    int ia = fa >> 8, ib = fb >> 8;
+    if (ia < r->x0) r->x0 = ia;
+    if (ib > r->x1) r->x1 = ib;
+
+    _path_flag(r, ia);
+    if (ia == ib) {
+        r->cov[ia] += fb - fa;
+        return;
     }
-    
-    free(el);
+    _path_flag(r, ia + 1);
+    _path_flag(r, ib);
+    r->cov[ia] += 256 - (fa & 0xFF);
+    r->acc[ia + 1] += 256;
+    r->acc[ib] -= 256;
+    r->cov[ib] += fb & 0xFF;
+}
+
+static void _path_blend_run(Uint32* dst, int count, int v, Uint32 color) {
+    Uint32 alpha = color & 0xFF;
+    if (v >= PATH_FULL_COVERAGE && alpha == 0xFF) {
+        for (int i = 0; i < count; i++) dst[i] = color;
+        return;
+    }
+    if (v > PATH_FULL_COVERAGE) v = PATH_FULL_COVERAGE;
+    Uint32 a = (alpha * v + PATH_FULL_COVERAGE / 2) / PATH_FULL_COVERAGE;
+    if (!a) return;
+    Uint32 src = (color & 0xFFFFFF00) | a;
+    for (int i = 0; i < count; i++) dst[i] = _blend_pixel(dst[i], src);
+}
+
+static int _path_inside(int wind, UIFillRule rule) {
+    return (rule == UI_FILL_EVENODD) ? (wind & 1) : (wind != 0);
 }
 
-UIElement* sxui_clone(UIElement* element) {
-    if (!element) return NULL;
-    
-    UIElement* clone = NULL;
-    
-    switch (element->type) {
-        case UI_BUTTON: {
-            UIButton* src = (UIButton*)element;
-            clone = sxui_button(NULL, src->text, NULL);
-            break;
-        }
-        case UI_LABEL: {
-            UILabel* src = (UILabel*)element;
-            clone = sxui_label(NULL, src->text);
-            break;
-        }
-        case UI_INPUT: {
-            UITextInput* src = (UITextInput*)element;
-            clone = sxui_input(NULL, src->placeholder, (element->flags & UI_FLAG_PASSWORD));
-            sxui_set_text(clone, src->text);
-            break;
-        }
-        case UI_CHECKBOX: {
-            UICheckBox* src = (UICheckBox*)element;
-            clone = sxui_checkbox(NULL, src->text);
-            ((UICheckBox*)clone)->value = src->value;
-            break;
-        }
-        case UI_SLIDER: {
-            UISlider* src = (UISlider*)element;
-            clone = sxui_slider(NULL, src->value);
-            break;
-        }
-        case UI_DROPDOWN: {
-            UIDropdown* src = (UIDropdown*)element;
-            clone = sxui_dropdown(NULL, (const char**)src->options, src->option_count, src->selected_index);
-            break;
+// Scanline fill with an active edge table, sampled on PATH_SUBSAMPLES
+// sub-scanlines per pixel row for anti-aliasing.
+static void _canvas_fill_edges(UICanvas* c, PathEdge* edges, int n, Uint32 color, UIFillRule rule) {
+    int w = c->el.w, h = c->el.h;
+    if (n == 0 || w <= 0 || h <= 0) return;
+
+    if (!_path_sort_edges(edges, n, h)) return;
+
+    float ymax = edges[0].y1;
+    for (int i = 1; i < n; i++) {
+        if (edges[i].y1 > ymax) ymax = edges[i].y1;
+    }
+    int py0 = (int)floorf(edges[0].y0), py1 = (int)ceilf(ymax);
+    if (py0 < 0) py0 = 0;
+    if (py1 > h) py1 = h;
+    if (py0 >= py1) return;
+
+    PathRow row = {
+        calloc(w + 2, sizeof(int)), calloc(w + 2, sizeof(int)),
+        calloc((w >> 6) + 2, sizeof(Uint64)), w, w + 1, -1
+    };
+    int* active = malloc(n * sizeof(int));
+    float* xs = malloc(n * sizeof(float));
+    if (!row.cov || !row.acc || !row.bits || !active || !xs) {
+        free(row.cov); free(row.acc); free(row.bits); free(active); free(xs);
+        return;
+    }
+
+    int next = 0, nactive = 0;
+    int dx1 = w, dy1 = h, dx2 = 0, dy2 = 0;
+
+    for (int py = py0; py < py1; py++) {
+        // Gaps between contours have nothing to sample; skip to the row
+        // where the next edge starts.
+        if (nactive == 0) {
+            if (next >= n) break;
+            int first = edges[next].sub / PATH_SUBSAMPLES;
+            if (first > py) {
+                py = first - 1;
+                continue;
+            }
         }
-        case UI_FRAME: {
-            clone = sxui_frame(NULL, element->x, element->y, element->w, element->h, element->flags);
-            UIFrame* src = (UIFrame*)element;
-            UIFrame* dst = (UIFrame*)clone;
-            dst->padding = src->padding;
-            dst->spacing = src->spacing;
-            dst->max_grid_cols = src->max_grid_cols;
-            break;
+        for (int s = 0; s < PATH_SUBSAMPLES; s++) {
+            float sy = py + (s + 0.5f) / PATH_SUBSAMPLES;
+            int sub = py * PATH_SUBSAMPLES + s;
+
+            while (next < n && edges[next].sub <= sub) {
+                if (edges[next].y1 > sy) active[nactive++] = next;
+                next++;
+            }
+
+            int k = 0;
+            for (int i = 0; i < nactive; i++) {
+                int e = active[i];
+                if (edges[e].y1 <= sy) continue;
+                float x = edges[e].x0 + (sy - edges[e].y0) * edges[e].dxdy;
+                // Insertion sort; the order barely changes between sub-scanlines.
+                int j = k++;
+                while (j > 0 && xs[j - 1] > x) {
+                    xs[j] = xs[j - 1];
+                    active[j] = active[j - 1];
+                    j--;
+                }
+                xs[j] = x;
+                active[j] = e;
+            }
+            nactive = k;
+
+            int wind = 0;
+            for (int i = 0; i < nactive; i++) {
+                int was_inside = _path_inside(wind, rule);
+                wind += edges[active[i]].dir;
+                if (was_inside || !_path_inside(wind, rule)) continue;
+
+                int j = i + 1;
+                for (; j < nactive; j++) {
+                    wind += edges[active[j]].dir;
+                    if (!_path_inside(wind, rule)) break;
+                }
+                _path_add_span(&row, xs[i], (j < nactive) ? xs[j] : (float)w);
+                i = j;
+            }
         }
-        case UI_CANVAS: {
-            clone = sxui_canvas(NULL, element->x, element->y, element->w, element->h);
-            UICanvas* src = (UICanvas*)element;
-            UICanvas* dst = (UICanvas*)clone;
-            memcpy(dst->pixels, src->pixels, element->w * element->h * sizeof(Uint32));
-            break;
+
+        if (row.x0 > row.x1) continue;
+
+        Uint32* dst = &c->pixels[py * w];
+        int run = 0, last = row.x0 - 1;
+        for (int word = row.x0 >> 6; word <= row.x1 >> 6; word++) {
+            Uint64 bits = row.bits[word];
+            row.bits[word] = 0;
+            while (bits) {
+                int x = (word << 6) + _path_ctz(bits);
+                bits &= bits - 1;
+                if (run > 0 && x > last + 1) _path_blend_run(&dst[last + 1], x - last - 1, run, color);
+                run += row.acc[x];
+                int v = row.cov[x] + run;
+                row.cov[x] = 0;
+                row.acc[x] = 0;
+                if (v > 0 && x < w) _path_blend_run(&dst[x], 1, v, color);
+                last = x;
+            }
         }
+
+        if (row.x0 < dx1) dx1 = row.x0;
+        if (row.x1 + 1 > dx2) dx2 = row.x1 + 1 > w ? w : row.x1 + 1;
+        if (py < dy1) dy1 = py;
+        dy2 = py + 1;
+        row.x0 = w + 1;
+        row.x1 = -1;
     }
-    
-    if (clone) {
-        clone->x = element->x;
-        clone->y = element->y;
-        clone->w = element->w;
-        clone->h = element->h;
-        clone->flags = element->flags;
-        clone->z_index = element->z_index;
-        clone->transparency = element->transparency;
-        clone->custom_color = element->custom_color;
-        clone->has_custom_color = element->has_custom_color;
-        clone->effects = element->effects;
-        
-        if (element->effects.gradient.stops) {
-            clone->effects.gradient.stops = list_new();
-            for (size_t i = 0; i < list_length(element->effects.gradient.stops); i++) {
-                GradientStop* orig = list_get(element->effects.gradient.stops, i);
-                GradientStop* copy = malloc(sizeof(GradientStop));
-                *copy = *orig;
-                list_add(clone->effects.gradient.stops, copy);
+
+    free(row.cov);
+    free(row.acc);
+    free(row.bits);
+    free(active);
+    free(xs);
+    if (dx1 < dx2) _canvas_mark_dirty(c, dx1, dy1, dx2, dy2);
+}
+
+static int _path_build_edges(const float* pts, const int* starts, int contours, int count, PathEdge** out) {
+    PathEdge* edges = malloc((count + 1) * sizeof(PathEdge));
+    if (!edges) return 0;
+    int n = 0;
+
+    for (int ci = 0; ci < contours; ci++) {
+        int first = starts[ci];
+        int last = (ci + 1 < contours) ? starts[ci + 1] : count;
+        if (last - first < 2) continue;
+
+        for (int i = first; i < last; i++) {
+            int j = (i + 1 < last) ? i + 1 : first;
+            float x0 = pts[i * 2], y0 = pts[i * 2 + 1];
+            float x1 = pts[j * 2], y1 = pts[j * 2 + 1];
+            if (y0 == y1) continue;
+
+            PathEdge* e = &edges[n++];
+            e->dir = (y1 > y0) ? 1 : -1;
+            if (y1 < y0) {
+                float t = x0; x0 = x1; x1 = t;
+                t = y0; y0 = y1; y1 = t;
             }
+            e->x0 = x0; e->y0 = y0;
+            e->x1 = x1; e->y1 = y1;
+            e->dxdy = (x1 - x0) / (y1 - y0);
         }
     }
-    
-    return clone;
+
+    *out = edges;
+    return n;
 }
 
-void sxui_delete(UIElement* element) {
-    if (!element) return;
-    
-    if (element == engine.focused) {
-        engine.focused = NULL;
+// Fills, then repeats the fill shifted by the canvas width when a scrolling
+// canvas's shape crosses the seam.
+static void _canvas_fill_shape(UICanvas* c, PathEdge* edges, int n, Uint32 color, UIFillRule rule) {
+    _canvas_fill_edges(c, edges, n, color, rule);
+    if (!c->ring || n == 0) return;
+
+    float xmin = edges[0].x0, xmax = edges[0].x0;
+    for (int i = 0; i < n; i++) {
+        float lo = edges[i].x0 < edges[i].x1 ? edges[i].x0 : edges[i].x1;
+        float hi = edges[i].x0 > edges[i].x1 ? edges[i].x0 : edges[i].x1;
+        if (lo < xmin) xmin = lo;
+        if (hi > xmax) xmax = hi;
     }
-    if (element == engine.dragging_el) {
-        engine.dragging_el = NULL;
+    int s = _ring_shift(c, (int)floorf(xmin), (int)ceilf(xmax) - 1);
+    if (!s) return;
+    _ring_seam(c);
+    for (int i = 0; i < n; i++) {
+        edges[i].x0 += s;
+        edges[i].x1 += s;
     }
-    
-    if (element->parent) {
-        list_remove(element->parent->children, element);
-        if (element->parent->type == UI_FRAME) {
-            sx_update_layout((UIFrame*)element->parent);
-        }
-    } else {
-        list_remove(engine.root, element);
+    _canvas_fill_edges(c, edges, n, color, rule);
+}
+
+void sxui_canvas_fill_path(UIElement* canvas, UIPath* path, Uint32 color, UIFillRule rule) {
+    UICanvas* c;
+    if (!_canvas_get(canvas, &c) || !path || path->count < 3) return;
+
+    PathEdge* edges = NULL;
+    int n = _path_build_edges(path->pts, path->starts, path->contours, path->count, &edges);
+    _canvas_fill_shape(c, edges, n, color, rule);
+    free(edges);
+}
+
+void sxui_canvas_fill_polygon(UIElement* canvas, const SDL_FPoint* points, int count, Uint32 color, UIFillRule rule) {
+    UICanvas* c;
+    if (!_canvas_get(canvas, &c) || !points || count < 3) return;
+
+    int start = 0;
+    PathEdge* edges = NULL;
+    int n = _path_build_edges((const float*)points, &start, 1, count, &edges);
+    _canvas_fill_shape(c, edges, n, color, rule);
+    free(edges);
+}
+
+// --- Flood fill ---
+
+typedef struct {
+    int x1, x2, y, dy;
+} FillSpan;
+
+typedef struct {
+    UICanvas* c;
+    Uint8* visited;
+    Uint32 seed, color;
+    int tolerance;
+    FillSpan* stack;
+    int count, cap;
+    int x1, y1, x2, y2;
+} FloodFill;
+
+static inline int _fill_match(const FloodFill* f, Uint32 p) {
+    if (p == f->seed) return 1;
+    if (f->tolerance == 0) return 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        int d = (int)((p >> shift) & 0xFF) - (int)((f->seed >> shift) & 0xFF);
+        if (d < -f->tolerance || d > f->tolerance) return 0;
     }
-    
-    _delete_element_recursive(element);
+    return 1;
 }
 
-void sxui_set_position(UIElement* el, int x, int y) {
-    if (el) { el->x = x; el->y = y; }
+static inline int _fill_inside(const FloodFill* f, const Uint32* row, const Uint8* vrow, int x) {
+    return (!vrow || !vrow[x]) && _fill_match(f, row[x]);
 }
 
-void sxui_set_size(UIElement* el, int w, int h) {
-    if (el) { 
-        el->w = w; 
-        el->h = h;
-        
-        if (el->type == UI_CANVAS) {
-            UICanvas* c = (UICanvas*)el;
-            if (c->texture) SDL_DestroyTexture(c->texture);
-            if (c->pixels) free(c->pixels);
-            
-            c->texture = SDL_CreateTexture(engine.renderer, SDL_PIXELFORMAT_RGBA8888,
-                                          SDL_TEXTUREACCESS_STREAMING, w, h);
-            c->pixels = calloc(w * h, sizeof(Uint32));
-            c->pitch = w * sizeof(Uint32);
-        }
+// Length of the matching run starting at x, scanning right up to `limit`.
+// The exact-match case is the common bucket fill and gets a bare loop.
+static inline int _fill_run(const FloodFill* f, const Uint32* row, const Uint8* vrow, int x, int limit) {
+    int start = x;
+    if (!vrow && f->tolerance == 0) {
+        Uint32 seed = f->seed;
+        while (x < limit && row[x] == seed) x++;
+    } else {
+        while (x < limit && _fill_inside(f, row, vrow, x)) x++;
     }
+    return x - start;
 }
 
-void sxui_set_visible(UIElement* el, int visible) {
-    if (el) {
-        if (visible) el->flags &= ~UI_FLAG_HIDDEN;
-        else el->flags |= UI_FLAG_HIDDEN;
-        
-        for (size_t i = 0; i < list_length(el->children); i++) {
-            sxui_set_visible(list_get(el->children, i), visible);
+static void _fill_push(FloodFill* f, int x1, int x2, int y, int dy) {
+    if (y < 0 || y >= f->c->el.h) return;
+    if (f->count == f->cap) {
+        int cap = f->cap ? f->cap * 2 : 256;
+        FillSpan* stack = realloc(f->stack, cap * sizeof(FillSpan));
+        if (!stack) return;
+        f->stack = stack;
+        f->cap = cap;
+    }
+    f->stack[f->count++] = (FillSpan){x1, x2, y, dy};
+}
+
+// Paints [x1, x2] on one row and grows the damage box.
+static void _fill_span(FloodFill* f, Uint32* row, Uint8* vrow, int x1, int x2, int y) {
+    for (int x = x1; x <= x2; x++) row[x] = f->color;
+    if (vrow) memset(&vrow[x1], 1, x2 - x1 + 1);
+    if (x1 < f->x1) f->x1 = x1;
+    if (x2 + 1 > f->x2) f->x2 = x2 + 1;
+    if (y < f->y1) f->y1 = y;
+    if (y + 1 > f->y2) f->y2 = y + 1;
+}
+
+// Span-based scanline fill (Heckbert's "seed fill") with an explicit stack:
+// whole runs are scanned and painted at once, each row is revisited only
+// from its neighbours' spans, and there is no recursion.
+void sxui_canvas_flood_fill(UIElement* canvas, int x, int y, Uint32 color, int tolerance) {
+    UICanvas* c;
+    if (!_canvas_get(canvas, &c)) return;
+    int w = c->el.w, h = c->el.h;
+    if (x < 0 || x >= w || y < 0 || y >= h) return;
+
+    FloodFill f = {0};
+    f.c = c;
+    f.seed = c->pixels[y * w + x];
+    f.color = color;
+    f.tolerance = tolerance < 0 ? 0 : tolerance;
+    f.x1 = w; f.y1 = h;
+    if (color == f.seed) return;
+
+    // Painted pixels normally stop matching the seed, which is what keeps
+    // the fill from revisiting them. When the new color still matches,
+    // track visited pixels explicitly.
+    if (_fill_match(&f, color)) {
+        f.visited = calloc((size_t)w * h, 1);
+        if (!f.visited) return;
+    }
+
+    _fill_push(&f, x, x, y, 1);
+    _fill_push(&f, x, x, y - 1, -1);
+
+    while (f.count > 0) {
+        FillSpan s = f.stack[--f.count];
+        int x1 = s.x1, x2 = s.x2, sy = s.y, dy = s.dy;
+        Uint32* row = &c->pixels[sy * w];
+        Uint8* vrow = f.visited ? &f.visited[sy * w] : NULL;
+        int lx = x1;
+
+        if (_fill_inside(&f, row, vrow, lx)) {
+            while (lx > 0 && _fill_inside(&f, row, vrow, lx - 1)) lx--;
+            if (lx < x1) {
+                _fill_span(&f, row, vrow, lx, x1 - 1, sy);
+                _fill_push(&f, lx, x1 - 1, sy - dy, -dy);
+            }
+        }
+
+        while (x1 <= x2) {
+            int start = x1;
+            x1 += _fill_run(&f, row, vrow, x1, w);
+            if (x1 > start) _fill_span(&f, row, vrow, start, x1 - 1, sy);
+            if (x1 > lx) _fill_push(&f, lx, x1 - 1, sy + dy, dy);
+            if (x1 - 1 > x2) _fill_push(&f, x2 + 1, x1 - 1, sy - dy, -dy);
+
+            x1++;
+            while (x1 < x2 && !_fill_inside(&f, row, vrow, x1)) x1++;
+            lx = x1;
         }
     }
+
+    free(f.stack);
+    free(f.visited);
+    if (f.x1 < f.x2) _canvas_mark_dirty(c, f.x1, f.y1, f.x2, f.y2);
 }
 
-void sxui_set_draggable(UIElement* el, int draggable) {
-    if (el) {
-        if (draggable) el->flags |= UI_FLAG_DRAGGABLE;
-        else el->flags &= ~UI_FLAG_DRAGGABLE;
+// --- History ---
+
+#define HISTORY_TILE_SHIFT 6
+#define HISTORY_TILE (1 << HISTORY_TILE_SHIFT)
+#define HISTORY_RUN_BIT 0x8000
+#define HISTORY_MAX_PACKET 0x7FFF
+
+typedef struct {
+    Uint8* data;
+    Uint32 size;
+} HistoryBlob;
+
+typedef struct {
+    int* tiles;
+    HistoryBlob* blobs;
+    int count;
+    size_t bytes;
+} HistoryStep;
+
+// Every tile's last checkpointed contents are kept compressed in `committed`.
+// Drawing appends each newly touched tile to `dirty`; a checkpoint swaps the
+// old blob of those tiles into a new step, and undo/redo swap a step's blobs
+// back, so both cost O(touched tiles). The scratch buffers live here rather
+// than in statics so canvases can be checkpointed from different threads.
+struct UICanvasHistory {
+    int w, h, cols, rows;
+    const Uint32* target;
+    HistoryBlob* committed;
+    Uint8* touched;
+    int* dirty;
+    int dirty_count;
+    int pending;
+    HistoryStep* steps;
+    int count, cap, cursor;
+    size_t budget, bytes;
+    Uint32 scratch[HISTORY_TILE * HISTORY_TILE];
+    Uint8 packed[HISTORY_TILE * HISTORY_TILE * 6];
+};
+
+// Per-entry bookkeeping of a step, charged to the budget with its blobs.
+#define HISTORY_ENTRY_BYTES (sizeof(int) + sizeof(HistoryBlob))
+
+// Tiles are packed as a sequence of packets with a 16-bit header: the high
+// bit marks a run of one repeated pixel, otherwise that many literal pixels
+// follow. Flat paint regions collapse to a few bytes per row.
+static Uint32 _history_compress(const Uint32* src, int count, Uint8* out) {
+    Uint8* p = out;
+    int i = 0;
+    while (i < count) {
+        int run = 1;
+        while (i + run < count && run < HISTORY_MAX_PACKET && src[i + run] == src[i]) run++;
+        if (run >= 3) {
+            Uint16 hdr = HISTORY_RUN_BIT | run;
+            memcpy(p, &hdr, 2);
+            memcpy(p + 2, &src[i], 4);
+            p += 6;
+            i += run;
+            continue;
+        }
+
+        int lit = 0;
+        while (i + lit < count && lit < HISTORY_MAX_PACKET) {
+            if (i + lit + 2 < count && src[i + lit] == src[i + lit + 1] &&
+                src[i + lit] == src[i + lit + 2]) break;
+            lit++;
+        }
+        Uint16 hdr = lit;
+        memcpy(p, &hdr, 2);
+        memcpy(p + 2, &src[i], lit * 4);
+        p += 2 + lit * 4;
+        i += lit;
+    }
+    return (Uint32)(p - out);
+}
+
+static void _history_decompress(const Uint8* in, Uint32 size, Uint32* dst) {
+    const Uint8* end = in + size;
+    while (in < end) {
+        Uint16 hdr;
+        memcpy(&hdr, in, 2);
+        int n = hdr & HISTORY_MAX_PACKET;
+        if (hdr & HISTORY_RUN_BIT) {
+            Uint32 v;
+            memcpy(&v, in + 2, 4);
+            for (int i = 0; i < n; i++) dst[i] = v;
+            in += 6;
+        } else {
+            memcpy(dst, in + 2, n * 4);
+            in += 2 + n * 4;
+        }
+        dst += n;
     }
 }
 
-void sxui_set_flags(UIElement* el, int flags) {
-    if (el) el->flags = flags;
+static void _history_tile_rect(UICanvasHistory* h, int tile, SDL_Rect* r) {
+    r->x = (tile % h->cols) << HISTORY_TILE_SHIFT;
+    r->y = (tile / h->cols) << HISTORY_TILE_SHIFT;
+    r->w = (r->x + HISTORY_TILE > h->w) ? h->w - r->x : HISTORY_TILE;
+    r->h = (r->y + HISTORY_TILE > h->h) ? h->h - r->y : HISTORY_TILE;
 }
 
-int sxui_get_flags(UIElement* el) {
-    return el ? el->flags : 0;
-}
+static HistoryBlob _history_capture(UICanvas* c, int tile) {
+    UICanvasHistory* h = c->history;
+    SDL_Rect r;
+    _history_tile_rect(h, tile, &r);
 
-<<<<<<< HEAD
-void sxui_set_z_index(UIElement* el, int z) {
-    if (el) el->z_index = z;
+    for (int y = 0; y < r.h; y++) {
+        memcpy(&h->scratch[y * r.w], &c->pixels[(r.y + y) * c->el.w + r.x], r.w * sizeof(Uint32));
+    }
+    HistoryBlob b = { NULL, _history_compress(h->scratch, r.w * r.h, h->packed) };
+    b.data = malloc(b.size);
+    if (b.data) memcpy(b.data, h->packed, b.size);
+    else b.size = 0;
+    return b;
 }
 
-int sxui_get_z_index(UIElement* el) {
-    return el ? el->z_index : 0;
-}
+static void _history_restore(UICanvas* c, int tile, HistoryBlob* b) {
+    UICanvasHistory* h = c->history;
+    SDL_Rect r;
+    _history_tile_rect(h, tile, &r);
 
-void sxui_set_transparency(UIElement* el, float alpha) {
-    if (el) el->transparency = (alpha < 0.0f) ? 0.0f : (alpha > 1.0f ? 1.0f : alpha);
+    _history_decompress(b->data, b->size, h->scratch);
+    for (int y = 0; y < r.h; y++) {
+        memcpy(&c->pixels[(r.y + y) * c->el.w + r.x], &h->scratch[y * r.w], r.w * sizeof(Uint32));
+    }
 }
 
-float sxui_get_transparency(UIElement* el) {
-    return el ? el->transparency : 1.0f;
+static void _history_free_step(UICanvasHistory* h, HistoryStep* s) {
+    for (int i = 0; i < s->count; i++) free(s->blobs[i].data);
+    free(s->tiles);
+    free(s->blobs);
+    h->bytes -= s->bytes;
+    memset(s, 0, sizeof(*s));
+}
+
+static void _history_free(UICanvasHistory* h) {
+    if (!h) return;
+    for (int i = 0; i < h->count; i++) _history_free_step(h, &h->steps[i]);
+    for (int i = 0; i < h->cols * h->rows; i++) free(h->committed[i].data);
+    free(h->committed);
+    free(h->touched);
+    free(h->dirty);
+    free(h->steps);
+    free(h);
+}
+
+static UICanvasHistory* _history_new(UICanvas* c, size_t budget) {
+    UICanvasHistory* h = calloc(1, sizeof(UICanvasHistory));
+    if (!h) return NULL;
+    h->w = c->el.w;
+    h->h = c->el.h;
+    h->cols = (h->w + HISTORY_TILE - 1) >> HISTORY_TILE_SHIFT;
+    h->rows = (h->h + HISTORY_TILE - 1) >> HISTORY_TILE_SHIFT;
+    h->target = c->pixels;
+    h->budget = budget;
+    h->committed = calloc(h->cols * h->rows + 1, sizeof(HistoryBlob));
+    h->touched = calloc(h->cols * h->rows + 1, 1);
+    h->dirty = malloc((h->cols * h->rows + 1) * sizeof(int));
+    if (!h->committed || !h->touched || !h->dirty) {
+        free(h->committed);
+        free(h->touched);
+        free(h->dirty);
+        free(h);
+        return NULL;
+    }
+
+    c->history = h;
+    for (int i = 0; i < h->cols * h->rows; i++) h->committed[i] = _history_capture(c, i);
+    return h;
 }
 
-void sxui_set_custom_color(UIElement* el, Uint32 color) {
-    if (el) {
-        el->custom_color = color;
-        el->has_custom_color = 1;
+static void _history_touch(UICanvasHistory* h, int x1, int y1, int x2, int y2) {
+    if (x2 > h->w) x2 = h->w;
+    if (y2 > h->h) y2 = h->h;
+    if (x1 >= x2 || y1 >= y2) return;
+
+    int tx2 = (x2 - 1) >> HISTORY_TILE_SHIFT, ty2 = (y2 - 1) >> HISTORY_TILE_SHIFT;
+    for (int ty = y1 >> HISTORY_TILE_SHIFT; ty <= ty2; ty++) {
+        for (int tx = x1 >> HISTORY_TILE_SHIFT; tx <= tx2; tx++) {
+            int tile = ty * h->cols + tx;
+            if (h->touched[tile]) continue;
+            h->touched[tile] = 1;
+            h->dirty[h->dirty_count++] = tile;
+        }
     }
+    h->pending = 1;
 }
 
-Uint32 sxui_get_custom_color(UIElement* el) {
-    return el ? el->custom_color : SX_COLOR_NONE;
+static void _history_clear_dirty(UICanvasHistory* h) {
+    for (int i = 0; i < h->dirty_count; i++) h->touched[h->dirty[i]] = 0;
+    h->dirty_count = 0;
+    h->pending = 0;
 }
 
-const char* sxui_get_text(UIElement* el) {
-    if (!el) return NULL;
-    if (el->type == UI_BUTTON) return ((UIButton*)el)->text;
-    if (el->type == UI_LABEL) return ((UILabel*)el)->text;
-    if (el->type == UI_INPUT) return ((UITextInput*)el)->text;
-    if (el->type == UI_CHECKBOX) return ((UICheckBox*)el)->text;
-=======
-UIElement *sxui_get_last_element(void) { return engine.last_created; }
+// A resize or a switch to another layer invalidates every recorded tile;
+// start over from the current pixels.
+static UICanvasHistory* _history_sync(UICanvas* c) {
+    UICanvasHistory* h = c->history;
+    if (!h || (h->w == c->el.w && h->h == c->el.h && h->target == c->pixels)) return h;
+    size_t budget = h->budget;
+    _history_free(h);
+    c->history = NULL;
+    return _history_new(c, budget);
+}
 
-const char *sxui_get_text(UIElement *el) {
-  if (!el)
->>>>>>> 410878f (feat: Add new pages and enhance input handling)
-    return NULL;
+static void _history_enforce_budget(UICanvasHistory* h) {
+    int drop = 0;
+    while (h->bytes > h->budget && drop < h->cursor) {
+        _history_free_step(h, &h->steps[drop++]);
+    }
+    if (!drop) return;
+    memmove(h->steps, h->steps + drop, (h->count - drop) * sizeof(HistoryStep));
+    h->count -= drop;
+    h->cursor -= drop;
+}
+
+static void _history_swap_step(UICanvas* c, HistoryStep* s) {
+    UICanvasHistory* h = c->history;
+    h->bytes -= s->bytes;
+    s->bytes = s->count * HISTORY_ENTRY_BYTES;
+    for (int i = 0; i < s->count; i++) {
+        int tile = s->tiles[i];
+        HistoryBlob tmp = h->committed[tile];
+        h->committed[tile] = s->blobs[i];
+        s->blobs[i] = tmp;
+        s->bytes += tmp.size;
+
+        SDL_Rect r;
+        _history_tile_rect(h, tile, &r);
+        _history_restore(c, tile, &h->committed[tile]);
+        _canvas_mark_dirty(c, r.x, r.y, r.x + r.w, r.y + r.h);
+    }
+    h->bytes += s->bytes;
+    // Restoring is not an edit; drop the tiles the restore itself touched.
+    _history_clear_dirty(h);
 }
 
-void sxui_set_text(UIElement* el, const char* text) {
-    if (!el || !text) return;
-    if (el->type == UI_BUTTON) {
-        free(((UIButton*)el)->text);
-        ((UIButton*)el)->text = strdup(text);
+void sxui_canvas_set_history(UIElement* canvas, size_t budget_bytes) {
+    UICanvas* c;
+    if (!_canvas_get(canvas, &c)) return;
+    if (!budget_bytes) {
+        _history_free(c->history);
+        c->history = NULL;
+        return;
     }
-    else if (el->type == UI_LABEL) {
-        free(((UILabel*)el)->text);
-        ((UILabel*)el)->text = strdup(text);
+    if (c->history) {
+        c->history->budget = budget_bytes;
+        _history_enforce_budget(c->history);
+        return;
     }
-    else if (el->type == UI_INPUT) {
-        UITextInput* inp = (UITextInput*)el;
-        strncpy(inp->text, text, INPUT_MAX - 1);
-        inp->len = strlen(inp->text);
-        inp->cursorPosition = inp->len;
-        inp->selectionAnchor = inp->len;
+    _history_new(c, budget_bytes);
+}
+
+void sxui_canvas_checkpoint(UIElement* canvas) {
+    UICanvas* c;
+    if (!_canvas_get(canvas, &c)) return;
+    UICanvasHistory* h = _history_sync(c);
+    if (!h || !h->pending) return;
+
+    HistoryStep s = {0};
+    s.tiles = malloc(h->dirty_count * sizeof(int));
+    s.blobs = malloc(h->dirty_count * sizeof(HistoryBlob));
+    if (!s.tiles || !s.blobs) {
+        free(s.tiles);
+        free(s.blobs);
+        return;
     }
-    else if (el->type == UI_CHECKBOX) {
-        free(((UICheckBox*)el)->text);
-        ((UICheckBox*)el)->text = strdup(text);
+    for (int i = 0; i < h->dirty_count; i++) {
+        int tile = h->dirty[i];
+        HistoryBlob now = _history_capture(c, tile);
+        HistoryBlob* old = &h->committed[tile];
+        if (now.size == old->size && memcmp(now.data, old->data, now.size) == 0) {
+            free(now.data);
+            continue;
+        }
+        s.tiles[s.count] = tile;
+        s.blobs[s.count] = *old;
+        s.bytes += old->size;
+        s.count++;
+        *old = now;
+    }
+    _history_clear_dirty(h);
+    if (!s.count) {
+        free(s.tiles);
+        free(s.blobs);
+        return;
+    }
+    // Trim the entry arrays to what the step keeps so the budget sees the
+    // real footprint.
+    int* tiles = realloc(s.tiles, s.count * sizeof(int));
+    HistoryBlob* blobs = realloc(s.blobs, s.count * sizeof(HistoryBlob));
+    if (tiles) s.tiles = tiles;
+    if (blobs) s.blobs = blobs;
+    s.bytes += s.count * HISTORY_ENTRY_BYTES;
+
+    // A new edit forks the timeline: anything that could be redone is gone.
+    for (int i = h->cursor; i < h->count; i++) _history_free_step(h, &h->steps[i]);
+    h->count = h->cursor;
+
+    if (h->count == h->cap) {
+        int cap = h->cap ? h->cap * 2 : 16;
+        HistoryStep* steps = realloc(h->steps, cap * sizeof(HistoryStep));
+        if (!steps) {
+            _history_free_step(h, &s);
+            return;
+        }
+        h->steps = steps;
+        h->cap = cap;
     }
+    h->steps[h->count++] = s;
+    h->cursor = h->count;
+    h->bytes += s.bytes;
+    _history_enforce_budget(h);
 }
-float sxui_get_value(UIElement* el) {
-    if (!el) return 0.0f;
-    if (el->type == UI_SLIDER) return ((UISlider*)el)->value;
-    if (el->type == UI_CHECKBOX) return (float)((UICheckBox*)el)->value;
-    return 0.0f;
+
+int sxui_canvas_undo(UIElement* canvas) {
+    UICanvas* c;
+    if (!_canvas_get(canvas, &c) || !c->history) return 0;
+    sxui_canvas_checkpoint(canvas);
+    UICanvasHistory* h = c->history;
+    if (!h || h->cursor == 0) return 0;
+    _history_swap_step(c, &h->steps[--h->cursor]);
+    return 1;
 }
 
-void sxui_set_value(UIElement* el, float value) {
-    if (!el) return;
-    if (el->type == UI_SLIDER) {
-        UISlider* s = (UISlider*)el;
-        s->value = value;
-        if (s->value < 0) s->value = 0;
-        if (s->value > 1) s->value = 1;
+int sxui_canvas_redo(UIElement* canvas) {
+    UICanvas* c;
+    if (!_canvas_get(canvas, &c) || !c->history) return 0;
+    sxui_canvas_checkpoint(canvas);
+    UICanvasHistory* h = c->history;
+    if (!h || h->cursor == h->count) return 0;
+    _history_swap_step(c, &h->steps[h->cursor++]);
+    return 1;
+}
+
+int sxui_canvas_can_undo(UIElement* canvas) {
+    UICanvas* c;
+    if (!_canvas_get(canvas, &c) || !c->history) return 0;
+    return c->history->cursor > 0 || c->history->pending;
+}
+
+int sxui_canvas_can_redo(UIElement* canvas) {
+    UICanvas* c;
+    if (!_canvas_get(canvas, &c) || !c->history) return 0;
+    return c->history->cursor < c->history->count && !c->history->pending;
+}
+
+size_t sxui_canvas_history_bytes(UIElement* canvas) {
+    UICanvas* c;
+    if (!_canvas_get(canvas, &c) || !c->history) return 0;
+    return c->history->bytes;
+}
+
+// --- Scrolling ---
+// In scrolling mode the columns form a ring: ring_head is the buffer column
+// shown at the left edge. Scrolling recycles the oldest columns as the
+// newest ones and rendering stitches the two halves back together with two
+// copies, so nothing is moved or redrawn. Drawing calls take buffer columns
+// and wrap at the seam, so a trace can be continued from the column
+// sxui_canvas_scroll_x returns by plain offsets, even past either end.
+
+static int _ring_head(UICanvas* c) {
+    return c->el.w > 0 ? c->ring_head % c->el.w : 0;
+}
+
+static void _ring_clear(UICanvas* c, int x1, int x2, Uint32 background) {
+    for (int y = 0; y < c->el.h; y++) _canvas_fill_span(c, x1, x2 - 1, y, background);
+    _canvas_mark_dirty(c, x1, 0, x2, c->el.h);
+}
+
+void sxui_canvas_set_scrolling(UIElement* canvas, int enabled) {
+    UICanvas* c;
+    if (!_canvas_get(canvas, &c)) return;
+    if (enabled && (c->buffers[0] || c->layers || c->mapped)) return;
+    c->ring = enabled != 0;
+    c->ring_head = 0;
+}
+
+void sxui_canvas_scroll(UIElement* canvas, int columns, Uint32 background) {
+    UICanvas* c;
+    if (!_canvas_get(canvas, &c) || !c->ring || columns <= 0) return;
+    int w = c->el.w;
+    if (columns >= w) {
+        _ring_clear(c, 0, w, background);
+        c->ring_head = 0;
+        return;
     }
-    else if (el->type == UI_CHECKBOX) {
-        ((UICheckBox*)el)->value = (int)value;
+
+    int head = _ring_head(c);
+    int end = head + columns;
+    if (end <= w) {
+        _ring_clear(c, head, end, background);
+    } else {
+        // Upload the right-hand piece now so the two pieces are not merged
+        // into one full-width dirty rectangle.
+        _ring_clear(c, head, w, background);
+        if (c->texture) _canvas_flush(c);
+        _ring_clear(c, 0, end - w, background);
     }
+    c->ring_head = end % w;
 }
 
-int sxui_get_dropdown_index(UIElement* el) {
-    if (!el || el->type != UI_DROPDOWN) return -1;
-    return ((UIDropdown*)el)->selected_index;
+int sxui_canvas_scroll_x(UIElement* canvas, int x) {
+    UICanvas* c;
+    if (!_canvas_get(canvas, &c) || !c->ring || c->el.w <= 0) return x;
+    x %= c->el.w;
+    if (x < 0) x += c->el.w;
+    return (x + _ring_head(c)) % c->el.w;
 }
 
-void sxui_set_gradient(UIElement* el, float* positions, Uint32* colors, int count, float angle) {
-    if (!el || count < 2) return;
-    
-    if (el->effects.gradient.stops) {
-        for (size_t i = 0; i < list_length(el->effects.gradient.stops); i++) {
-            free(list_get(el->effects.gradient.stops, i));
+// --- Mapped storage ---
+
+// File layout: a one-page header followed by the raw RGBA8888 rows, so the
+// pixel data starts page-aligned and a file written by one run can be mapped
+// straight back by the next.
+#define MAPPED_MAGIC 0x56435853u
+#define MAPPED_VERSION 1
+#define MAPPED_HEADER 4096
+#define MAPPED_SYNC_MS 250
+
+typedef struct {
+    Uint32 magic, version, w, h;
+} MappedHeader;
+
+struct CanvasMapping {
+    int fd;
+    Uint8* base;
+    size_t size;
+    int w, h;
+    SDL_Thread* thread;
+    SDL_mutex* lock;
+    SDL_cond* wake;
+    int quit;
+    int sync_y1, sync_y2;   // rows waiting for msync; guarded by lock
+    int tex_w, tex_h;
+    SDL_Rect shown;         // image region currently held by the texture
+};
+
+// Only an empty file, or one this canvas already owns (a resize), may be
+// reinitialised; opening a canvas file of another size or an unrelated
+// file fails instead of wiping it.
+static int _mapped_map(CanvasMapping* m, int w, int h, int owned) {
+#ifdef SXUI_MMAP
+    size_t size = MAPPED_HEADER + (size_t)w * h * sizeof(Uint32);
+    struct stat st;
+    if (fstat(m->fd, &st) != 0) return SDL_SetError("fstat failed");
+
+    int reuse = 0;
+    if (st.st_size != 0) {
+        MappedHeader hd = {0};
+        int canvas_file = pread(m->fd, &hd, sizeof(hd), 0) == (ssize_t)sizeof(hd) &&
+                          hd.magic == MAPPED_MAGIC && hd.version == MAPPED_VERSION;
+        reuse = canvas_file && (size_t)st.st_size == size &&
+                hd.w == (Uint32)w && hd.h == (Uint32)h;
+        if (!reuse && !owned) {
+            return SDL_SetError(canvas_file ? "canvas file is %ux%u, not %dx%d"
+                                            : "not a canvas file",
+                                hd.w, hd.h, w, h);
         }
-        list_free(el->effects.gradient.stops);
     }
-    
-    el->effects.gradient.stops = list_new();
-    el->effects.gradient.enabled = 1;
-    el->effects.gradient.angle = angle;
-    
-    int valid_count = 0;
-    for (int i = 0; i < count; i++) {
-        if (positions && colors) {
-            GradientStop* stop = malloc(sizeof(GradientStop));
-            stop->position = positions[i];
-            stop->color = colors[i];
-            list_add(el->effects.gradient.stops, stop);
-            valid_count++;
-        } else if (positions && !colors) {
-            GradientStop* stop = malloc(sizeof(GradientStop));
-            stop->position = positions[i];
-            stop->color = SX_COLOR_WHITE;
-            list_add(el->effects.gradient.stops, stop);
-            valid_count++;
-            printf("Warning: Missing color for gradient stop %d, using white\n", i);
-        }
+    // A fresh file is truncated and regrown, which leaves it sparse and
+    // zero-filled, i.e. a transparent canvas.
+    if (!reuse && (ftruncate(m->fd, 0) != 0 || ftruncate(m->fd, (off_t)size) != 0))
+        return SDL_SetError("could not size canvas file");
+
+    void* base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, m->fd, 0);
+    if (base == MAP_FAILED) return SDL_SetError("mmap failed");
+    m->base = base;
+    m->size = size;
+    m->w = w;
+    m->h = h;
+    if (!reuse) {
+        MappedHeader hd = {MAPPED_MAGIC, MAPPED_VERSION, (Uint32)w, (Uint32)h};
+        memcpy(base, &hd, sizeof(hd));
     }
-    
-    if (valid_count < 2) {
-        printf("Warning: Gradient needs at least 2 valid stops\n");
-        sxui_clear_gradient(el);
+    return 0;
+#else
+    (void)m; (void)w; (void)h; (void)owned;
+    return SDL_SetError("mapped canvases are not supported on this platform");
+#endif
+}
+
+// Flushes rows [y1, y2) to the file. The start is rounded down to a page
+// boundary as msync requires.
+static void _mapped_msync(CanvasMapping* m, int y1, int y2) {
+#ifdef SXUI_MMAP
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t row = (size_t)m->w * sizeof(Uint32);
+    size_t start = MAPPED_HEADER + (size_t)y1 * row;
+    size_t end = MAPPED_HEADER + (size_t)y2 * row;
+    start -= start % page;
+    msync(m->base + start, end - start, MS_SYNC);
+#else
+    (void)m; (void)y1; (void)y2;
+#endif
+}
+
+static void _mapped_unmap(CanvasMapping* m) {
+    if (!m->base) return;
+    _mapped_msync(m, 0, m->h);
+#ifdef SXUI_MMAP
+    munmap(m->base, m->size);
+#endif
+    m->base = NULL;
+    m->size = 0;
+}
+
+static int _mapped_take(CanvasMapping* m, int* y1, int* y2) {
+    *y1 = m->sync_y1;
+    *y2 = m->sync_y2;
+    m->sync_y1 = m->sync_y2 = 0;
+    return *y1 < *y2;
+}
+
+// Writes dirty rows back every MAPPED_SYNC_MS so the UI thread never blocks
+// on disk I/O. The lock only guards the pending row range, not the msync.
+static int _mapped_sync_thread(void* data) {
+    CanvasMapping* m = data;
+    SDL_LockMutex(m->lock);
+    while (!m->quit) {
+        SDL_CondWaitTimeout(m->wake, m->lock, MAPPED_SYNC_MS);
+        int y1, y2;
+        if (m->quit || !_mapped_take(m, &y1, &y2)) continue;
+        SDL_UnlockMutex(m->lock);
+        _mapped_msync(m, y1, y2);
+        SDL_LockMutex(m->lock);
     }
+    SDL_UnlockMutex(m->lock);
+    return 0;
 }
 
-void sxui_clear_gradient(UIElement* el) {
-    if (!el) return;
-    
-    if (el->effects.gradient.stops) {
-        for (size_t i = 0; i < list_length(el->effects.gradient.stops); i++) {
-            free(list_get(el->effects.gradient.stops, i));
-        }
-        list_free(el->effects.gradient.stops);
-        el->effects.gradient.stops = NULL;
-    }
-    
-    el->effects.gradient.enabled = 0;
+static void _mapped_start(CanvasMapping* m) {
+    m->quit = 0;
+    m->thread = SDL_CreateThread(_mapped_sync_thread, "sxui-msync", m);
 }
 
-void sxui_set_outline(UIElement* el, int width, Uint32 color, Uint8 alpha) {
-    if (!el) return;
-    
-    el->effects.outline.enabled = 1;
-    el->effects.outline.width = width;
-    el->effects.outline.color = color;
-    el->effects.outline.alpha = alpha;
+static void _mapped_stop(CanvasMapping* m) {
+    if (!m->thread) return;
+    SDL_LockMutex(m->lock);
+    m->quit = 1;
+    SDL_CondSignal(m->wake);
+    SDL_UnlockMutex(m->lock);
+    SDL_WaitThread(m->thread, NULL);
+    m->thread = NULL;
 }
 
-void sxui_clear_outline(UIElement* el) {
-    if (!el) return;
-    el->effects.outline.enabled = 0;
-}
+static void _mapped_touch(CanvasMapping* m, int y1, int y2) {
+    SDL_LockMutex(m->lock);
+    if (m->sync_y1 >= m->sync_y2) {
+        m->sync_y1 = y1;
+        m->sync_y2 = y2;
+    } else {
+        if (y1 < m->sync_y1) m->sync_y1 = y1;
+        if (y2 > m->sync_y2) m->sync_y2 = y2;
+    }
+    SDL_UnlockMutex(m->lock);
+}
+
+// Resizing discards the contents just like a heap canvas does. If the file
+// cannot be regrown the canvas collapses to 0x0 rather than keep a stale
+// pointer.
+static void _mapped_resize(UICanvas* c) {
+    CanvasMapping* m = c->mapped;
+    _mapped_stop(m);
+    _mapped_unmap(m);
+    m->sync_y1 = m->sync_y2 = 0;
+    m->shown.w = 0;
+    if (c->texture) SDL_DestroyTexture(c->texture);
+    c->texture = NULL;
+    m->tex_w = m->tex_h = 0;
+    c->dirty = 0;
+
+    if (c->el.w <= 0 || c->el.h <= 0 || _mapped_map(m, c->el.w, c->el.h, 1) != 0) {
+        c->el.w = c->el.h = 0;
+        c->pixels = NULL;
+        c->pitch = 0;
+        return;
+    }
+    c->pixels = (Uint32*)(m->base + MAPPED_HEADER);
+    c->pitch = c->el.w * sizeof(Uint32);
+    _mapped_start(m);
+}
+
+static void _mapped_close(UICanvas* c) {
+    CanvasMapping* m = c->mapped;
+    if (!m) return;
+    _mapped_stop(m);
+    _mapped_unmap(m);
+#ifdef SXUI_MMAP
+    if (m->fd >= 0) close(m->fd);
+#endif
+    SDL_DestroyCond(m->wake);
+    SDL_DestroyMutex(m->lock);
+    free(m);
+    c->mapped = NULL;
+    c->pixels = NULL;
+}
+
+// Only the part of the canvas that is on screen and inside the current clip
+// lives in the texture, so an image far larger than the maximum texture size
+// can be scrolled through. The texture is re-filled when the visible region
+// moves; otherwise only damage inside it is uploaded.
+static void _mapped_render(UICanvas* c, int wx, int wy, Uint8 alpha) {
+    CanvasMapping* m = c->mapped;
+    if (!c->pixels) return;
+    SDL_Rect vis = {wx, wy, c->el.w, c->el.h};
+    SDL_Rect bounds = {0, 0, 0, 0};
+    SDL_GetRendererOutputSize(engine.renderer, &bounds.w, &bounds.h);
+    if (!SDL_IntersectRect(&vis, &bounds, &vis)) return;
+    if (SDL_RenderIsClipEnabled(engine.renderer)) {
+        SDL_RenderGetClipRect(engine.renderer, &bounds);
+        if (!SDL_IntersectRect(&vis, &bounds, &vis)) return;
+    }
+    SDL_Rect src = {vis.x - wx, vis.y - wy, vis.w, vis.h};
+
+    if (!c->texture || vis.w > m->tex_w || vis.h > m->tex_h) {
+        if (c->texture) SDL_DestroyTexture(c->texture);
+        if (vis.w > m->tex_w) m->tex_w = vis.w;
+        if (vis.h > m->tex_h) m->tex_h = vis.h;
+        c->texture = SDL_CreateTexture(engine.renderer, SDL_PIXELFORMAT_RGBA8888,
+                                       SDL_TEXTUREACCESS_STREAMING, m->tex_w, m->tex_h);
+        if (!c->texture) return;
+        m->shown.w = 0;
+    }
 
-void sxui_set_rounded_corners(UIElement* el, int radius) {
-    if (!el) return;
-    
-    el->effects.rounded.enabled = 1;
-    el->effects.rounded.radius = radius;
-}
+    SDL_Rect t = {0, 0, src.w, src.h};
+    if (!SDL_RectEquals(&src, &m->shown)) {
+        SDL_UpdateTexture(c->texture, &t, &c->pixels[src.y * c->el.w + src.x], c->pitch);
+        m->shown = src;
+    } else if (c->dirty) {
+        SDL_Rect d = {c->dirty_x1, c->dirty_y1,
+                      c->dirty_x2 - c->dirty_x1, c->dirty_y2 - c->dirty_y1}, r;
+        if (SDL_IntersectRect(&d, &src, &r)) {
+            SDL_Rect u = {r.x - src.x, r.y - src.y, r.w, r.h};
+            SDL_UpdateTexture(c->texture, &u, &c->pixels[r.y * c->el.w + r.x], c->pitch);
+        }
+    }
+    // Damage outside the visible region is dropped: scrolling it into view
+    // moves the region and triggers a full refill anyway.
+    c->dirty = 0;
 
-void sxui_clear_rounded_corners(UIElement* el) {
-    if (!el) return;
-    el->effects.rounded.enabled = 0;
+    SDL_SetTextureBlendMode(c->texture, SDL_BLENDMODE_BLEND);
+    SDL_SetTextureAlphaMod(c->texture, alpha);
+    SDL_RenderCopy(engine.renderer, c->texture, &t, &vis);
 }
 
-void sxui_canvas_clear(UIElement* canvas, Uint32 color) {
-    if (!canvas || canvas->type != UI_CANVAS) return;
-    
-    UICanvas* c = (UICanvas*)canvas;
-    for (int i = 0; i < canvas->w * canvas->h; i++) {
-        c->pixels[i] = color;
+UIElement* sxui_canvas_open_mapped(UIElement* parent, const char* path, int w, int h) {
+    if (!path || w <= 0 || h <= 0) return NULL;
+    UICanvas* c = calloc(1, sizeof(UICanvas));
+    CanvasMapping* m = calloc(1, sizeof(CanvasMapping));
+    if (!c || !m) {
+        free(c);
+        free(m);
+        return NULL;
     }
-    
-    SDL_UpdateTexture(c->texture, NULL, c->pixels, c->pitch);
+    m->fd = -1;
+#ifdef SXUI_MMAP
+    m->fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (m->fd < 0) SDL_SetError("could not open %s", path);
+#else
+    SDL_SetError("mapped canvases are not supported on this platform");
+#endif
+    if (m->fd < 0 || _mapped_map(m, w, h, 0) != 0) {
+#ifdef SXUI_MMAP
+        if (m->fd >= 0) close(m->fd);
+#endif
+        free(m);
+        free(c);
+        return NULL;
+    }
+    m->lock = SDL_CreateMutex();
+    m->wake = SDL_CreateCond();
+
+    init_base(&c->el, 0, 0, w, h, UI_CANVAS);
+    c->mapped = m;
+    c->pixels = (Uint32*)(m->base + MAPPED_HEADER);
+    c->pitch = w * sizeof(Uint32);
+    _mapped_start(m);
+    _add_to_parent(parent, (UIElement*)c);
+    return (UIElement*)c;
 }
 
-void sxui_canvas_draw_pixel(UIElement* canvas, int x, int y, Uint32 color) {
-    if (!canvas || canvas->type != UI_CANVAS) return;
-    
-    UICanvas* c = (UICanvas*)canvas;
-    if (x < 0 || x >= canvas->w || y < 0 || y >= canvas->h) return;
-    
-    c->pixels[y * canvas->w + x] = color;
-    SDL_UpdateTexture(c->texture, NULL, c->pixels, c->pitch);
+void sxui_canvas_sync(UIElement* canvas) {
+    if (!canvas || canvas->type != UI_CANVAS || !((UICanvas*)canvas)->mapped) return;
+    CanvasMapping* m = ((UICanvas*)canvas)->mapped;
+    int y1, y2, pending;
+    SDL_LockMutex(m->lock);
+    pending = _mapped_take(m, &y1, &y2);
+    SDL_UnlockMutex(m->lock);
+    if (pending) _mapped_msync(m, y1, y2);
 }
 
-void sxui_canvas_draw_line(UIElement* canvas, int x1, int y1, int x2, int y2, Uint32 color) {
-    if (!canvas || canvas->type != UI_CANVAS) return;
-    
-    UICanvas* c = (UICanvas*)canvas;
-    
-    int dx = abs(x2 - x1);
-    int dy = abs(y2 - y1);
-    int sx = x1 < x2 ? 1 : -1;
-    int sy = y1 < y2 ? 1 : -1;
-    int err = dx - dy;
-    
-    while (1) {
-        if (x1 >= 0 && x1 < canvas->w && y1 >= 0 && y1 < canvas->h) {
-            c->pixels[y1 * canvas->w + x1] = color;
-        }
-        
-        if (x1 == x2 && y1 == y2) break;
-        
-        int e2 = 2 * err;
-        if (e2 > -dy) {
-            err -= dy;
-            x1 += sx;
+// --- Particles ---
+// Fields live in separate arrays so the integration loops stream through
+// exactly the data they need, four particles at a time with SSE2. The
+// neighbour grid is rebuilt lazily after anything moves, and the whole
+// system is submitted as one geometry batch of quads.
+
+#define PARTICLE_DEFAULT_CELL 32.0f
+
+static int _particles_get(UIElement* el, UIParticles** out) {
+    if (!el || el->type != UI_PARTICLES) return 0;
+    *out = (UIParticles*)el;
+    return 1;
+}
+
+static int _particles_reserve(UIParticles* p, int n) {
+    if (n <= p->capacity) return 1;
+    int cap = p->capacity ? p->capacity : 256;
+    while (cap < n) cap *= 2;
+
+    float** fields[] = {&p->x, &p->y, &p->vx, &p->vy, &p->size};
+    for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+        float* f = realloc(*fields[i], (size_t)cap * sizeof(float));
+        if (!f) return 0;
+        *fields[i] = f;
+    }
+    Uint32* color = realloc(p->color, (size_t)cap * sizeof(Uint32));
+    if (!color) return 0;
+    p->color = color;
+    p->capacity = cap;
+    return 1;
+}
+
+// Advances one axis. Bouncing reflects the overshoot back inside [0, limit]
+// and flips the velocity; wrapping moves the particle to the opposite edge.
+static void _particles_integrate(float* pos, float* vel, int n, float dt, float limit, UIParticleEdge edge) {
+    int i = 0;
+#ifdef SXUI_SSE2
+    const __m128 vdt = _mm_set1_ps(dt);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 lim = _mm_set1_ps(limit);
+    const __m128 lim2 = _mm_set1_ps(2 * limit);
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    for (; i + 4 <= n; i += 4) {
+        __m128 v = _mm_loadu_ps(vel + i);
+        __m128 p = _mm_add_ps(_mm_loadu_ps(pos + i), _mm_mul_ps(v, vdt));
+        if (edge == UI_PARTICLE_EDGE_BOUNCE) {
+            __m128 lo = _mm_cmplt_ps(p, zero);
+            __m128 hi = _mm_cmpgt_ps(p, lim);
+            p = _mm_or_ps(_mm_and_ps(lo, _mm_sub_ps(zero, p)), _mm_andnot_ps(lo, p));
+            p = _mm_or_ps(_mm_and_ps(hi, _mm_sub_ps(lim2, p)), _mm_andnot_ps(hi, p));
+            _mm_storeu_ps(vel + i, _mm_xor_ps(v, _mm_and_ps(_mm_or_ps(lo, hi), sign)));
+        } else if (edge == UI_PARTICLE_EDGE_WRAP) {
+            __m128 lo = _mm_cmplt_ps(p, zero);
+            __m128 hi = _mm_cmpge_ps(p, lim);
+            p = _mm_sub_ps(_mm_add_ps(p, _mm_and_ps(lo, lim)), _mm_and_ps(hi, lim));
         }
-        if (e2 < dx) {
-            err += dx;
-            y1 += sy;
+        _mm_storeu_ps(pos + i, p);
+    }
+#endif
+    for (; i < n; i++) {
+        float p = pos[i] + vel[i] * dt;
+        if (edge == UI_PARTICLE_EDGE_BOUNCE) {
+            if (p < 0) {
+                p = -p;
+                vel[i] = -vel[i];
+            } else if (p > limit) {
+                p = 2 * limit - p;
+                vel[i] = -vel[i];
+            }
+        } else if (edge == UI_PARTICLE_EDGE_WRAP) {
+            if (p < 0) p += limit;
+            else if (p >= limit) p -= limit;
         }
+        pos[i] = p;
     }
-    
-    SDL_UpdateTexture(c->texture, NULL, c->pixels, c->pitch);
 }
 
-void sxui_canvas_draw_rect(UIElement* canvas, int x, int y, int w, int h, Uint32 color, int filled) {
-    if (!canvas || canvas->type != UI_CANVAS) return;
-    
-    UICanvas* c = (UICanvas*)canvas;
-    
-    if (filled) {
-        for (int py = y; py < y + h; py++) {
-            for (int px = x; px < x + w; px++) {
-                if (px >= 0 && px < canvas->w && py >= 0 && py < canvas->h) {
-                    c->pixels[py * canvas->w + px] = color;
-                }
-            }
-        }
-    } else {
-        for (int px = x; px < x + w; px++) {
-            if (px >= 0 && px < canvas->w) {
-                if (y >= 0 && y < canvas->h) c->pixels[y * canvas->w + px] = color;
-                if (y + h - 1 >= 0 && y + h - 1 < canvas->h) c->pixels[(y + h - 1) * canvas->w + px] = color;
-            }
+static int _particle_cell_coord(float v, float cell, int n) {
+    int c = (int)floorf(v / cell);
+    if (c < 0) return 0;
+    return c >= n ? n - 1 : c;
+}
+
+// Counting sort of particle indices by cell. Positions are copied in cell
+// order, so a query scans one contiguous range per grid row. Particles
+// outside the element are clamped into the border cells so queries never
+// miss them. Layouts resize elements without going through sxui_set_size,
+// so a grid built for other dimensions counts as stale too.
+static int _particles_build_grid(UIParticles* p) {
+    int cols = (int)ceilf(p->el.w / p->cell), rows = (int)ceilf(p->el.h / p->cell);
+    if (cols < 1) cols = 1;
+    if (rows < 1) rows = 1;
+    if (p->grid_valid && cols == p->cols && rows == p->rows) return 1;
+    int cells = cols * rows;
+
+    if (cells + 1 > p->grid_cells) {
+        int* start = realloc(p->cell_start, (size_t)(cells + 1) * sizeof(int));
+        if (!start) return 0;
+        p->cell_start = start;
+        p->grid_cells = cells + 1;
+    }
+    if (p->capacity > p->grid_items) {
+        size_t n = (size_t)p->capacity;
+        int* items = realloc(p->cell_items, n * sizeof(int));
+        if (items) p->cell_items = items;
+        int* cell_of = realloc(p->cell_of, n * sizeof(int));
+        if (cell_of) p->cell_of = cell_of;
+        float* cell_x = realloc(p->cell_x, n * sizeof(float));
+        if (cell_x) p->cell_x = cell_x;
+        float* cell_y = realloc(p->cell_y, n * sizeof(float));
+        if (cell_y) p->cell_y = cell_y;
+        if (!items || !cell_of || !cell_x || !cell_y) return 0;
+        p->grid_items = p->capacity;
+    }
+    p->cols = cols;
+    p->rows = rows;
+
+    memset(p->cell_start, 0, (size_t)(cells + 1) * sizeof(int));
+    for (int i = 0; i < p->count; i++) {
+        int c = _particle_cell_coord(p->y[i], p->cell, rows) * cols +
+                _particle_cell_coord(p->x[i], p->cell, cols);
+        p->cell_of[i] = c;
+        p->cell_start[c]++;
+    }
+    for (int c = 1; c <= cells; c++) p->cell_start[c] += p->cell_start[c - 1];
+    for (int i = p->count - 1; i >= 0; i--) {
+        int k = --p->cell_start[p->cell_of[i]];
+        p->cell_items[k] = i;
+        p->cell_x[k] = p->x[i];
+        p->cell_y[k] = p->y[i];
+    }
+    p->grid_valid = 1;
+    return 1;
+}
+
+static void _particles_render(UIParticles* p, int wx, int wy, Uint8 alpha) {
+    int n = p->count;
+    if (n == 0) return;
+
+    if (p->vertex_cap < n) {
+        SDL_Vertex* verts = realloc(p->verts, (size_t)p->capacity * 4 * sizeof(SDL_Vertex));
+        if (!verts) return;
+        p->verts = verts;
+        int* indices = realloc(p->indices, (size_t)p->capacity * 6 * sizeof(int));
+        if (!indices) return;
+        p->indices = indices;
+        for (int i = p->vertex_cap; i < p->capacity; i++) {
+            int* q = &indices[i * 6];
+            int v = i * 4;
+            q[0] = v; q[1] = v + 1; q[2] = v + 2;
+            q[3] = v; q[4] = v + 2; q[5] = v + 3;
         }
-        for (int py = y; py < y + h; py++) {
-            if (py >= 0 && py < canvas->h) {
-                if (x >= 0 && x < canvas->w) c->pixels[py * canvas->w + x] = color;
-                if (x + w - 1 >= 0 && x + w - 1 < canvas->w) c->pixels[py * canvas->w + (x + w - 1)] = color;
-            }
+        p->vertex_cap = p->capacity;
+    }
+
+    static const SDL_FPoint uv[4] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+    SDL_Vertex* v = p->verts;
+    for (int i = 0; i < n; i++, v += 4) {
+        float h = p->size[i] * 0.5f;
+        float x = wx + p->x[i], y = wy + p->y[i];
+        Uint32 c = p->color[i];
+        SDL_Color col = {(Uint8)(c >> 24), (Uint8)(c >> 16), (Uint8)(c >> 8),
+                         (Uint8)(((c & 0xFF) * alpha + 127) / 255)};
+        v[0].position = (SDL_FPoint){x - h, y - h};
+        v[1].position = (SDL_FPoint){x + h, y - h};
+        v[2].position = (SDL_FPoint){x + h, y + h};
+        v[3].position = (SDL_FPoint){x - h, y + h};
+        for (int k = 0; k < 4; k++) {
+            v[k].color = col;
+            v[k].tex_coord = uv[k];
         }
     }
-    
-    SDL_UpdateTexture(c->texture, NULL, c->pixels, c->pitch);
+    SDL_RenderGeometry(engine.renderer, p->texture, p->verts, n * 4, p->indices, n * 6);
+}
+
+static void _particles_free(UIParticles* p) {
+    free(p->x);
+    free(p->y);
+    free(p->vx);
+    free(p->vy);
+    free(p->size);
+    free(p->color);
+    free(p->cell_start);
+    free(p->cell_items);
+    free(p->cell_of);
+    free(p->cell_x);
+    free(p->cell_y);
+    free(p->verts);
+    free(p->indices);
+}
+
+static UIElement* _particles_clone(UIParticles* src) {
+    UIParticles* p = (UIParticles*)sxui_particles(NULL, src->el.x, src->el.y, src->el.w, src->el.h);
+    if (!p) return NULL;
+    p->edge = src->edge;
+    p->cell = src->cell;
+    p->texture = src->texture;
+    if (!_particles_reserve(p, src->count)) return (UIElement*)p;
+    size_t f = (size_t)src->count * sizeof(float);
+    memcpy(p->x, src->x, f);
+    memcpy(p->y, src->y, f);
+    memcpy(p->vx, src->vx, f);
+    memcpy(p->vy, src->vy, f);
+    memcpy(p->size, src->size, f);
+    memcpy(p->color, src->color, (size_t)src->count * sizeof(Uint32));
+    p->count = src->count;
+    return (UIElement*)p;
+}
+
+UIElement* sxui_particles(UIElement* parent, int x, int y, int w, int h) {
+    UIParticles* p = calloc(1, sizeof(UIParticles));
+    if (!p) return NULL;
+    init_base(&p->el, x, y, w, h, UI_PARTICLES);
+    p->edge = UI_PARTICLE_EDGE_BOUNCE;
+    p->cell = PARTICLE_DEFAULT_CELL;
+    _add_to_parent(parent, (UIElement*)p);
+    return (UIElement*)p;
+}
+
+int sxui_particles_emit(UIElement* el, float x, float y, float vx, float vy, float size, Uint32 color) {
+    UIParticles* p;
+    if (!_particles_get(el, &p) || !_particles_reserve(p, p->count + 1)) return -1;
+    int i = p->count++;
+    p->x[i] = x;
+    p->y[i] = y;
+    p->vx[i] = vx;
+    p->vy[i] = vy;
+    p->size[i] = size;
+    p->color[i] = color;
+    p->grid_valid = 0;
+    return i;
 }
 
-void sxui_canvas_draw_circle(UIElement* canvas, int cx, int cy, int radius, Uint32 color, int filled) {
-    if (!canvas || canvas->type != UI_CANVAS) return;
-    
-    UICanvas* c = (UICanvas*)canvas;
-    
-    if (filled) {
-        for (int y = -radius; y <= radius; y++) {
-            for (int x = -radius; x <= radius; x++) {
-                if (x * x + y * y <= radius * radius) {
-                    int px = cx + x;
-                    int py = cy + y;
-                    if (px >= 0 && px < canvas->w && py >= 0 && py < canvas->h) {
-                        c->pixels[py * canvas->w + px] = color;
-                    }
-                }
-            }
-        }
-    } else {
-        int x = 0;
-        int y = radius;
-        int d = 3 - 2 * radius;
-        
-        while (y >= x) {
-            int points[8][2] = {
-                {cx + x, cy + y}, {cx - x, cy + y},
-                {cx + x, cy - y}, {cx - x, cy - y},
-                {cx + y, cy + x}, {cx - y, cy + x},
-                {cx + y, cy - x}, {cx - y, cy - x}
-            };
-            
-            for (int i = 0; i < 8; i++) {
-                int px = points[i][0];
-                int py = points[i][1];
-                if (px >= 0 && px < canvas->w && py >= 0 && py < canvas->h) {
-                    c->pixels[py * canvas->w + px] = color;
-                }
-            }
-            
-            x++;
-            if (d > 0) {
-                y--;
-                d = d + 4 * (x - y) + 10;
-            } else {
-                d = d + 4 * x + 6;
-            }
+// Swap-removes, so the last particle takes over the removed index.
+void sxui_particles_remove(UIElement* el, int index) {
+    UIParticles* p;
+    if (!_particles_get(el, &p) || index < 0 || index >= p->count) return;
+    int last = --p->count;
+    p->x[index] = p->x[last];
+    p->y[index] = p->y[last];
+    p->vx[index] = p->vx[last];
+    p->vy[index] = p->vy[last];
+    p->size[index] = p->size[last];
+    p->color[index] = p->color[last];
+    p->grid_valid = 0;
+}
+
+void sxui_particles_clear(UIElement* el) {
+    UIParticles* p;
+    if (!_particles_get(el, &p)) return;
+    p->count = 0;
+    p->grid_valid = 0;
+}
+
+int sxui_particles_count(UIElement* el) {
+    UIParticles* p;
+    return _particles_get(el, &p) ? p->count : 0;
+}
+
+// The arrays stay valid until the next emit. Velocities, sizes and colours
+// can be edited in place; the neighbour grid only sees position edits after
+// the next update, emit or remove.
+SXParticles sxui_particles_data(UIElement* el) {
+    SXParticles d = {0};
+    UIParticles* p;
+    if (!_particles_get(el, &p)) return d;
+    d.x = p->x;
+    d.y = p->y;
+    d.vx = p->vx;
+    d.vy = p->vy;
+    d.size = p->size;
+    d.color = p->color;
+    d.count = p->count;
+    return d;
+}
+
+void sxui_particles_update(UIElement* el, float dt) {
+    UIParticles* p;
+    if (!_particles_get(el, &p) || p->count == 0) return;
+    _particles_integrate(p->x, p->vx, p->count, dt, (float)el->w, p->edge);
+    _particles_integrate(p->y, p->vy, p->count, dt, (float)el->h, p->edge);
+    p->grid_valid = 0;
+}
+
+void sxui_particles_set_edge(UIElement* el, UIParticleEdge edge) {
+    UIParticles* p;
+    if (_particles_get(el, &p)) p->edge = edge;
+}
+
+void sxui_particles_set_texture(UIElement* el, SDL_Texture* texture) {
+    UIParticles* p;
+    if (_particles_get(el, &p)) p->texture = texture;
+}
+
+void sxui_particles_set_cell_size(UIElement* el, float cell) {
+    UIParticles* p;
+    if (!_particles_get(el, &p) || cell <= 0) return;
+    p->cell = cell;
+    p->grid_valid = 0;
+}
+
+// Writes up to max indices of particles within radius of (x, y) and returns
+// the total number found, which may exceed max.
+int sxui_particles_query(UIElement* el, float x, float y, float radius, int* out, int max) {
+    UIParticles* p;
+    if (!_particles_get(el, &p) || p->count == 0 || !_particles_build_grid(p)) return 0;
+    int cx1 = _particle_cell_coord(x - radius, p->cell, p->cols);
+    int cx2 = _particle_cell_coord(x + radius, p->cell, p->cols);
+    int cy1 = _particle_cell_coord(y - radius, p->cell, p->rows);
+    int cy2 = _particle_cell_coord(y + radius, p->cell, p->rows);
+    float r2 = radius * radius;
+    int found = 0;
+
+    for (int cy = cy1; cy <= cy2; cy++) {
+        int end = p->cell_start[cy * p->cols + cx2 + 1];
+        for (int k = p->cell_start[cy * p->cols + cx1]; k < end; k++) {
+            float dx = p->cell_x[k] - x, dy = p->cell_y[k] - y;
+            if (dx * dx + dy * dy > r2) continue;
+            if (found < max) out[found] = p->cell_items[k];
+            found++;
         }
     }
-    
-    SDL_UpdateTexture(c->texture, NULL, c->pixels, c->pitch);
+    return found;
 }
 
 void sxui_frame_set_padding(UIElement* frame, int padding) {
     if (frame && frame->type == UI_FRAME) {
         ((UIFrame*)frame)->padding = padding;
-        sx_update_layout((UIFrame*)frame);
+        _layout_invalidate(frame, 0);
     }
 }
 
 void sxui_frame_set_spacing(UIElement* frame, int spacing) {
     if (frame && frame->type == UI_FRAME) {
         ((UIFrame*)frame)->spacing = spacing;
-        sx_update_layout((UIFrame*)frame);
+        _layout_invalidate(frame, 0);
     }
 }
 
@@ -2386,14 +7554,14 @@ void sxui_frame_set_default_child_size(UIElement* frame, int w, int h) {
     if (frame && frame->type == UI_FRAME) {
         frame->target_w = w;
         frame->target_h = h;
-        sx_update_layout((UIFrame*)frame);
+        _layout_invalidate(frame, 0);
     }
 }
 
 void sxui_frame_set_grid_columns(UIElement* frame, int max_cols) {
     if (frame && frame->type == UI_FRAME) {
         ((UIFrame*)frame)->max_grid_cols = max_cols;
-        sx_update_layout((UIFrame*)frame);
+        _layout_invalidate(frame, 0);
     }
 }
 
@@ -2405,10 +7573,376 @@ void sxui_frame_set_scrollbar_width(UIElement* frame, int width) {
 
 void sxui_frame_update_layout(UIElement* frame) {
     if (frame && frame->type == UI_FRAME) {
+        ((UIFrame*)frame)->layout_from = 0;
         sx_update_layout((UIFrame*)frame);
     }
 }
 
+void sxui_set_flex(UIElement* el, float grow, float shrink, int basis) {
+    if (!el || !_flex_item(el)) return;
+    el->flex->grow = grow < 0 ? 0 : grow;
+    el->flex->shrink = shrink < 0 ? 0 : shrink;
+    el->flex->basis = basis;
+    _layout_invalidate_child(el);
+}
+
+void sxui_set_min_size(UIElement* el, int w, int h) {
+    if (!el || !_flex_item(el)) return;
+    el->flex->min_w = w;
+    el->flex->min_h = h;
+    _layout_invalidate_child(el);
+}
+
+void sxui_set_max_size(UIElement* el, int w, int h) {
+    if (!el || !_flex_item(el)) return;
+    el->flex->max_w = w;
+    el->flex->max_h = h;
+    _layout_invalidate_child(el);
+}
+
+void sxui_set_align_self(UIElement* el, UIFlexAlign align) {
+    if (!el || !_flex_item(el)) return;
+    el->flex->align_self = align;
+    _layout_invalidate_child(el);
+}
+
+void sxui_frame_set_justify(UIElement* frame, UIFlexJustify justify) {
+    if (frame && frame->type == UI_FRAME) {
+        ((UIFrame*)frame)->justify = justify;
+        _layout_invalidate(frame, 0);
+    }
+}
+
+void sxui_frame_set_align(UIElement* frame, UIFlexAlign align) {
+    if (frame && frame->type == UI_FRAME) {
+        ((UIFrame*)frame)->align = align;
+        _layout_invalidate(frame, 0);
+    }
+}
+
+void sxui_set_anchors(UIElement* el, int anchors) {
+    if (!el || !_constraint_get(el)) return;
+    UIConstraint* k = el->constraint;
+    int was_anchored = k->anchors != 0;
+    int pw, ph;
+    _constraint_parent_size(el, &pw, &ph);
+    k->anchors = anchors;
+    k->left = el->x;
+    k->top = el->y;
+    if ((anchors & UI_ANCHOR_CENTER_X) && !(anchors & (UI_ANCHOR_LEFT | UI_ANCHOR_RIGHT)))
+        k->left = el->x - (pw - el->w) / 2;
+    if ((anchors & UI_ANCHOR_CENTER_Y) && !(anchors & (UI_ANCHOR_TOP | UI_ANCHOR_BOTTOM)))
+        k->top = el->y - (ph - el->h) / 2;
+    k->right = pw - el->x - el->w;
+    k->bottom = ph - el->y - el->h;
+    k->parent_w = -1;
+    constraints_dirty = 1;
+    // Anchored elements are skipped by frame layouts; the siblings move up
+    // or down when an element enters or leaves the flow.
+    if (!was_anchored != !anchors) _layout_invalidate(el->parent, 0);
+}
+
+void sxui_set_anchor_margins(UIElement* el, int left, int top, int right, int bottom) {
+    if (!el || !_constraint_get(el)) return;
+    el->constraint->left = left;
+    el->constraint->top = top;
+    el->constraint->right = right;
+    el->constraint->bottom = bottom;
+    el->constraint->parent_w = -1;
+    constraints_dirty = 1;
+}
+
+void sxui_set_percent_size(UIElement* el, float w_percent, float h_percent) {
+    if (!el || !_constraint_get(el)) return;
+    el->constraint->pct_w = w_percent;
+    el->constraint->pct_h = h_percent;
+    el->constraint->parent_w = -1;
+    constraints_dirty = 1;
+    _layout_invalidate(el->parent, 0);
+}
+
+void sxui_set_auto_size(UIElement* el, int enabled) {
+    if (!el || !_element_text(el)) return;
+    if (!enabled) {
+        if (el->text_size) el->text_size->enabled = 0;
+        return;
+    }
+    if (!_text_size_get(el)) return;
+    el->text_size->enabled = 1;
+    _text_size_apply(el);
+}
+
+void sxui_set_text_padding(UIElement* el, int pad_x, int pad_y) {
+    if (!el || !_element_text(el) || !_text_size_get(el)) return;
+    el->text_size->pad_x = pad_x;
+    el->text_size->pad_y = pad_y;
+    _text_size_changed(el);
+}
+
+void sxui_frame_set_scroll_snap(UIElement* frame, int snap_x, int snap_y) {
+    if (frame && frame->type == UI_FRAME) {
+        ((UIFrame*)frame)->snap_x = snap_x;
+        ((UIFrame*)frame)->snap_y = snap_y;
+    }
+}
+
+void sxui_frame_scroll_to(UIElement* frame, int x, int y) {
+    if (frame && frame->type == UI_FRAME) _scroll_set((UIFrame*)frame, x, y);
+}
+
+void sxui_frame_fling(UIElement* frame, float vx, float vy) {
+    if (!frame || frame->type != UI_FRAME) return;
+    UIFrame* f = (UIFrame*)frame;
+    _scroll_start(f);
+    f->scroll_vx = vx;
+    f->scroll_vy = vy;
+}
+
+void sxui_frame_get_scroll(UIElement* frame, int* x, int* y) {
+    if (!frame || frame->type != UI_FRAME) return;
+    if (x) *x = ((UIFrame*)frame)->scroll_x;
+    if (y) *y = ((UIFrame*)frame)->scroll_y;
+}
+
+// --- Virtual list ---
+
+// Only the rows in view plus VLIST_MARGIN on each side exist as elements.
+// They are pooled children of the list frame and get rebound to other
+// indices as it scrolls. Row offsets are implicit while every row has the
+// default height; after the first per-row height they come from a prefix
+// sum that is rebuilt lazily from the first changed row.
+#define VLIST_MARGIN 4
+
+struct UIVirtualList {
+    int count;
+    int row_height;
+    VirtualListBindCallback bind;
+    int* heights;
+    int* offsets;
+    int offsets_valid;
+    int capacity;
+    UIElement** rows;
+    int* row_index;
+    int* slots;
+    int pool;
+    int first, last, row_w;
+    int rebind;
+};
+
+static int _vlist_offset(UIVirtualList* v, int i) {
+    if (!v->heights) return i * v->row_height;
+    if (v->offsets_valid < i) {
+        for (int k = v->offsets_valid; k < i; k++) v->offsets[k + 1] = v->offsets[k] + v->heights[k];
+        v->offsets_valid = i;
+    }
+    return v->offsets[i];
+}
+
+static int _vlist_height(UIVirtualList* v, int i) {
+    return v->heights ? v->heights[i] : v->row_height;
+}
+
+static int _vlist_index_at(UIVirtualList* v, int y) {
+    if (y <= 0 || v->count == 0) return 0;
+    if (!v->heights) return v->row_height > 0 ? y / v->row_height : 0;
+    int lo = 0, hi = v->count - 1;
+    _vlist_offset(v, v->count);
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (v->offsets[mid] <= y) lo = mid;
+        else hi = mid - 1;
+    }
+    return lo;
+}
+
+static int _vlist_reserve(UIVirtualList* v, int count) {
+    if (count <= v->capacity || !v->heights) return 1;
+    int cap = v->capacity ? v->capacity : 64;
+    while (cap < count) cap *= 2;
+    int* heights = realloc(v->heights, cap * sizeof(int));
+    if (!heights) return 0;
+    v->heights = heights;
+    int* offsets = realloc(v->offsets, (cap + 1) * sizeof(int));
+    if (!offsets) return 0;
+    v->offsets = offsets;
+    v->capacity = cap;
+    return 1;
+}
+
+static int _vlist_grow_pool(UIFrame* f, int n) {
+    UIVirtualList* v = f->virt;
+    if (n <= v->pool) return 1;
+    UIElement** rows = realloc(v->rows, n * sizeof(UIElement*));
+    if (!rows) return 0;
+    v->rows = rows;
+    int* row_index = realloc(v->row_index, n * sizeof(int));
+    if (!row_index) return 0;
+    v->row_index = row_index;
+    int* slots = realloc(v->slots, n * sizeof(int));
+    if (!slots) return 0;
+    v->slots = slots;
+    for (; v->pool < n; v->pool++) {
+        UIElement* row = sxui_frame(&f->el, 0, 0, f->el.w, v->row_height, UI_LAYOUT_HORIZONTAL);
+        ((UIFrame*)row)->padding = 0;
+        row->flags |= UI_FLAG_HIDDEN;
+        v->rows[v->pool] = row;
+        v->row_index[v->pool] = -1;
+    }
+    return 1;
+}
+
+// Rows whose index stays in range keep their binding; only rows that
+// scrolled out are rebound, to the indices that scrolled in. Lists inside a
+// hidden page or panel are left alone; every layout flush calls this again,
+// so the first one after the show brings them up to date.
+static void _vlist_sync(UIFrame* f) {
+    UIVirtualList* v = f->virt;
+    UIElement* el = &f->el;
+    for (UIElement* p = el; p; p = p->parent) {
+        if (p->flags & UI_FLAG_HIDDEN) return;
+    }
+
+    _hit_invalidate(el);
+    f->content_height = _vlist_offset(v, v->count);
+    f->content_width = el->w;
+    int limit = f->content_height - el->h;
+    if (f->scroll_y > limit) f->scroll_y = limit > 0 ? limit : 0;
+
+    int first = 0, last = -1;
+    if (v->count > 0) {
+        first = _vlist_index_at(v, f->scroll_y) - VLIST_MARGIN;
+        last = _vlist_index_at(v, f->scroll_y + el->h) + VLIST_MARGIN;
+        if (first < 0) first = 0;
+        if (last > v->count - 1) last = v->count - 1;
+    }
+    if (first == v->first && last == v->last && !v->rebind && el->w == v->row_w) return;
+
+    int n = last - first + 1;
+    if (!_vlist_grow_pool(f, n)) return;
+
+    for (int k = 0; k < n; k++) v->slots[k] = -1;
+    for (int r = 0; r < v->pool; r++) {
+        int i = v->row_index[r];
+        if (!v->rebind && i >= first && i <= last) v->slots[i - first] = r;
+        else v->row_index[r] = -1;
+    }
+
+    int free_row = 0;
+    for (int k = 0; k < n; k++) {
+        int i = first + k;
+        int r = v->slots[k];
+        int bind = r < 0;
+        if (bind) {
+            while (v->row_index[free_row] != -1) free_row++;
+            r = free_row;
+            v->row_index[r] = i;
+        }
+        UIElement* row = v->rows[r];
+        row->flags &= ~UI_FLAG_HIDDEN;
+        row->x = 0;
+        row->y = _vlist_offset(v, i);
+        int h = _vlist_height(v, i);
+        if (row->w != el->w || row->h != h) sxui_set_size(row, el->w, h);
+        if (bind && v->bind) v->bind(row, i);
+    }
+    for (int r = 0; r < v->pool; r++) {
+        if (v->row_index[r] == -1) v->rows[r]->flags |= UI_FLAG_HIDDEN;
+    }
+
+    v->first = first;
+    v->last = last;
+    v->row_w = el->w;
+    v->rebind = 0;
+}
+
+static void _vlists_sync(void) {
+    if (!virtual_lists) return;
+    for (size_t i = 0; i < list_length(virtual_lists); i++) _vlist_sync(list_get(virtual_lists, i));
+}
+
+static void _vlist_free(UIFrame* f) {
+    UIVirtualList* v = f->virt;
+    list_remove(virtual_lists, f);
+    free(v->heights);
+    free(v->offsets);
+    free(v->rows);
+    free(v->row_index);
+    free(v->slots);
+    free(v);
+    f->virt = NULL;
+}
+
+UIElement* sxui_virtual_list(UIElement* parent, int row_height, int count, VirtualListBindCallback bind) {
+    UIVirtualList* v = calloc(1, sizeof(UIVirtualList));
+    if (!v) return NULL;
+    UIElement* el = sxui_frame(parent, 0, 0, 0, 0, UI_SCROLLABLE | UI_FLAG_CLIP);
+    UIFrame* f = (UIFrame*)el;
+    f->padding = 0;
+    v->row_height = row_height > 0 ? row_height : 30;
+    v->count = count > 0 ? count : 0;
+    v->bind = bind;
+    v->last = -1;
+    f->virt = v;
+    if (!virtual_lists) virtual_lists = list_new();
+    list_add(virtual_lists, f);
+    return el;
+}
+
+static UIVirtualList* _vlist_get(UIElement* el) {
+    if (!el || el->type != UI_FRAME) return NULL;
+    return ((UIFrame*)el)->virt;
+}
+
+void sxui_virtual_list_set_count(UIElement* list, int count) {
+    UIVirtualList* v = _vlist_get(list);
+    if (!v) return;
+    if (count < 0) count = 0;
+    if (!_vlist_reserve(v, count)) return;
+    for (int i = v->count; v->heights && i < count; i++) v->heights[i] = v->row_height;
+    if (v->offsets_valid > count) v->offsets_valid = count;
+    v->count = count;
+    v->rebind = 1;
+}
+
+void sxui_virtual_list_set_row_height(UIElement* list, int index, int height) {
+    UIVirtualList* v = _vlist_get(list);
+    if (!v || index < 0 || index >= v->count) return;
+    if (!v->heights) {
+        int cap = 64;
+        while (cap < v->count) cap *= 2;
+        v->heights = malloc(cap * sizeof(int));
+        v->offsets = malloc((cap + 1) * sizeof(int));
+        if (!v->heights || !v->offsets) {
+            free(v->heights);
+            free(v->offsets);
+            v->heights = v->offsets = NULL;
+            return;
+        }
+        for (int i = 0; i < v->count; i++) v->heights[i] = v->row_height;
+        v->offsets[0] = 0;
+        v->offsets_valid = 0;
+        v->capacity = cap;
+    }
+    if (v->heights[index] == height) return;
+    v->heights[index] = height;
+    if (v->offsets_valid > index) v->offsets_valid = index;
+    // Rows below the change move, so every visible row is placed again.
+    v->row_w = -1;
+}
+
+void sxui_virtual_list_refresh(UIElement* list) {
+    UIVirtualList* v = _vlist_get(list);
+    if (v) v->rebind = 1;
+}
+
+void sxui_virtual_list_scroll_to(UIElement* list, int index) {
+    UIVirtualList* v = _vlist_get(list);
+    if (!v || v->count == 0) return;
+    if (index < 0) index = 0;
+    if (index >= v->count) index = v->count - 1;
+    _scroll_set((UIFrame*)list, 0, _vlist_offset(v, index));
+}
+
 // Added implementations for the missing functions
 int sxui_frame_get_child_count(UIElement* element) {
     if (!element || element->type != UI_FRAME) return 0;
@@ -2426,10 +7960,15 @@ void sxui_frame_add_child(UIElement* parent, UIElement* child) {
         // If child already has a parent, remove it from there first
         if (child->parent) {
              list_remove(child->parent->children, child);
+             _layout_invalidate(child->parent, 0);
         }
         child->parent = parent;
         list_add(parent->children, child);
-        if (parent->type == UI_FRAME) sx_update_layout((UIFrame*)parent);
+        _layout_invalidate(parent, list_length(parent->children) - 1);
+        if (child->constraint) {
+            child->constraint->parent_w = -1;
+            constraints_dirty = 1;
+        }
     }
 }
 
@@ -2535,68 +8074,68 @@ int sxui_get_page_count(void) {
 
 UIConnection sxui_on_click(UIElement* el, ClickCallback cb) {
     if (el && el->type == UI_BUTTON && cb) {
-        return bind_event(((UIButton*)el)->onClick, cb);
+        return bind_event(&((UIButton*)el)->onClick, cb);
     }
-    UIConnection empty = {0, NULL};
+    UIConnection empty = {0, 0};
     return empty;
 }
 
 UIConnection sxui_on_hover_enter(UIElement* el, HoverCallback cb) {
-    if (el && cb) return bind_event(el->onMouseEnter, cb);
-    UIConnection empty = {0, NULL};
+    if (el && cb) return bind_event(&el->onMouseEnter, cb);
+    UIConnection empty = {0, 0};
     return empty;
 }
 
 UIConnection sxui_on_hover_leave(UIElement* el, HoverCallback cb) {
-    if (el && cb) return bind_event(el->onMouseLeave, cb);
-    UIConnection empty = {0, NULL};
+    if (el && cb) return bind_event(&el->onMouseLeave, cb);
+    UIConnection empty = {0, 0};
     return empty;
 }
 
 UIConnection sxui_on_focus_changed(UIElement* el, FocusCallback cb) {
     if (el && el->type == UI_INPUT && cb) {
-        return bind_event(((UITextInput*)el)->onFocusChanged, cb);
+        return bind_event(&((UITextInput*)el)->onFocusChanged, cb);
     }
-    UIConnection empty = {0, NULL};
+    UIConnection empty = {0, 0};
     return empty;
 }
 
 UIConnection sxui_on_text_changed(UIElement* el, TextCallback cb) {
     if (el && el->type == UI_INPUT && cb) {
-        return bind_event(((UITextInput*)el)->onTextChanged, cb);
+        return bind_event(&((UITextInput*)el)->onTextChanged, cb);
     }
-    UIConnection empty = {0, NULL};
+    UIConnection empty = {0, 0};
     return empty;
 }
 
 UIConnection sxui_on_submit(UIElement* el, TextCallback cb) {
     if (el && el->type == UI_INPUT && cb) {
-        return bind_event(((UITextInput*)el)->onSubmit, cb);
+        return bind_event(&((UITextInput*)el)->onSubmit, cb);
     }
-    UIConnection empty = {0, NULL};
+    UIConnection empty = {0, 0};
     return empty;
 }
 
 UIConnection sxui_on_value_changed(UIElement* el, ValueCallback cb) {
     if (!el || !cb) {
-        UIConnection empty = {0, NULL};
+        UIConnection empty = {0, 0};
         return empty;
     }
     if (el->type == UI_SLIDER) {
-        return bind_event(((UISlider*)el)->onValueChanged, cb);
+        return bind_event(&((UISlider*)el)->onValueChanged, cb);
     }
     if (el->type == UI_CHECKBOX) {
-        return bind_event(((UICheckBox*)el)->onValueChanged, cb);
+        return bind_event(&((UICheckBox*)el)->onValueChanged, cb);
     }
-    UIConnection empty = {0, NULL};
+    UIConnection empty = {0, 0};
     return empty;
 }
 
 UIConnection sxui_on_dropdown_changed(UIElement* el, DropdownCallback cb) {
     if (el && el->type == UI_DROPDOWN && cb) {
-        return bind_event(((UIDropdown*)el)->onSelectionChanged, cb);
+        return bind_event(&((UIDropdown*)el)->onSelectionChanged, cb);
     }
-    UIConnection empty = {0, NULL};
+    UIConnection empty = {0, 0};
     return empty;
 }
 
@@ -2657,6 +8196,9 @@ void render_element_base(UIElement* e, int wx, int wy, Uint32 base_color) {
     }
 }
 
+static SDL_Rect render_cull;
+static int render_cull_on = 0;
+
 void sx_render_recursive(list* l, int mx, int my, int px, int py) {
     UIElement* sorted[1024];
     int count = 0;
@@ -2666,11 +8208,16 @@ void sx_render_recursive(list* l, int mx, int my, int px, int py) {
         UIElement* e = sorted[idx];
         
         int wx = px + e->x, wy = py + e->y;
-        int is_hovered = (mx >= wx && mx <= wx + e->w && my >= wy && my <= wy + e->h);
-        
-        if (is_hovered && !e->_is_hovered_prev) trigger_hover(e, 1);
-        else if (!is_hovered && e->_is_hovered_prev) trigger_hover(e, 0);
-        e->_is_hovered_prev = is_hovered;
+
+        // Children entirely outside the enclosing clip are skipped; open
+        // dropdowns draw past their bounds and are always kept.
+        if (render_cull_on && e->type != UI_DROPDOWN &&
+            (wx >= render_cull.x + render_cull.w || wx + e->w <= render_cull.x ||
+             wy >= render_cull.y + render_cull.h || wy + e->h <= render_cull.y)) {
+            continue;
+        }
+
+        int is_hovered = e->_is_hovered;
 
         Uint32 text_color = e->has_custom_color ? get_on_color(e->custom_color) : engine.theme.on_surface;
 
@@ -2681,16 +8228,24 @@ void sx_render_recursive(list* l, int mx, int my, int px, int py) {
                 render_element_base(e, wx, wy, frame_color);
                 
                 int should_clip = (e->flags & UI_FLAG_CLIP);
+                SDL_Rect saved_cull = render_cull;
+                int saved_cull_on = render_cull_on;
                 if (should_clip) {
                     SDL_Rect clip = {wx, wy, e->w, e->h};
                     SDL_RenderSetClipRect(engine.renderer, &clip);
+                    if (!render_cull_on || !SDL_IntersectRect(&saved_cull, &clip, &render_cull)) {
+                        render_cull = clip;
+                    }
+                    render_cull_on = 1;
                 }
-                sx_render_recursive(e->children, mx, my, wx, wy - f->scroll_y);
+                sx_render_recursive(e->children, mx, my, wx - f->scroll_x, wy - f->scroll_y);
+                render_cull = saved_cull;
+                render_cull_on = saved_cull_on;
                 if (should_clip) {
                     SDL_RenderSetClipRect(engine.renderer, NULL);
                 }
                 
-                Uint32 elapsed = SDL_GetTicks() - f->last_scroll_time;
+                Uint32 elapsed = _clock_ticks() - f->last_scroll_time;
                 if (elapsed < SCROLL_FADE_MS && f->content_height > e->h) {
                     float alpha = 1.0f - ((float)elapsed / SCROLL_FADE_MS);
                     Uint32 s_col = rgba_to_uint(150, 150, 150, (Uint8)(200 * alpha * e->transparency));
@@ -2698,13 +8253,20 @@ void sx_render_recursive(list* l, int mx, int my, int px, int py) {
                     int by = wy + (int)((float)f->scroll_y / f->content_height * e->h);
                     _draw_rect(wx + e->w - f->scroll_bar_width - 2, by, f->scroll_bar_width, bh, s_col);
                 }
+                if (elapsed < SCROLL_FADE_MS && (e->flags & UI_SCROLLABLE_X) && f->content_width > e->w) {
+                    float alpha = 1.0f - ((float)elapsed / SCROLL_FADE_MS);
+                    Uint32 s_col = rgba_to_uint(150, 150, 150, (Uint8)(200 * alpha * e->transparency));
+                    int bw = (int)((float)e->w / f->content_width * e->w);
+                    int bx = wx + (int)((float)f->scroll_x / f->content_width * e->w);
+                    _draw_rect(bx, wy + e->h - f->scroll_bar_width - 2, bw, f->scroll_bar_width, s_col);
+                }
                 break;
             }
             case UI_BUTTON: {
                 UIButton* b = (UIButton*)e;
                 Uint32 col = e->has_custom_color ? e->custom_color : engine.theme.primary;
                 if (is_hovered) col = shift_color(col, 1.2f);
-                if (b->_pressed && SDL_GetTicks() - b->_lastClickTime < 100) {
+                if (b->_pressed && _clock_ticks() - b->_lastClickTime < 100) {
                     col = shift_color(col, 0.8f);
                 } else {
                     b->_pressed = 0;
@@ -2778,7 +8340,7 @@ void sx_render_recursive(list* l, int mx, int my, int px, int py) {
                     }
                 }
 
-                if (is_focused && (SDL_GetTicks() % 1000) < 500) {
+                if (is_focused && (_clock_ticks() % 1000) < 500) {
                     int cx;
                     if (is_pass) {
                         cx = ti->cursorPosition * _measure_text("*") - ti->scrollOffset;
@@ -2897,19 +8459,44 @@ void sx_render_recursive(list* l, int mx, int my, int px, int py) {
             }
             case UI_CANVAS: {
                 UICanvas* c = (UICanvas*)e;
+                if (c->tiles) {
+                    _tiled_render(c, wx, wy, (Uint8)(255 * e->transparency));
+                    break;
+                }
+                if (c->mapped) {
+                    _mapped_render(c, wx, wy, (Uint8)(255 * e->transparency));
+                    break;
+                }
+                _canvas_flush(c);
                 SDL_SetTextureBlendMode(c->texture, SDL_BLENDMODE_BLEND);
                 SDL_SetTextureAlphaMod(c->texture, (Uint8)(255 * e->transparency));
+                int head = c->ring ? _ring_head(c) : 0;
+                if (head) {
+                    SDL_Rect older = {head, 0, e->w - head, e->h};
+                    SDL_Rect newer = {0, 0, head, e->h};
+                    SDL_Rect dst_older = {wx, wy, e->w - head, e->h};
+                    SDL_Rect dst_newer = {wx + e->w - head, wy, head, e->h};
+                    SDL_RenderCopy(engine.renderer, c->texture, &older, &dst_older);
+                    SDL_RenderCopy(engine.renderer, c->texture, &newer, &dst_newer);
+                    break;
+                }
                 SDL_Rect dst = {wx, wy, e->w, e->h};
                 SDL_RenderCopy(engine.renderer, c->texture, NULL, &dst);
                 break;
             }
+            case UI_PARTICLES:
+                _particles_render((UIParticles*)e, wx, wy, (Uint8)(255 * e->transparency));
+                break;
         }
     }
 }
 
 void sxui_render(void) {
+    in_render = 1;
+    _scroll_step();
+    sxui_layout_flush();
     int mx, my;
-    SDL_GetMouseState(&mx, &my);
+    _mouse_state(&mx, &my);
     
     Uint8 r, g, b, a;
     uint_to_rgba(engine.theme.background, &r, &g, &b, &a);
@@ -2917,5 +8504,8 @@ void sxui_render(void) {
     SDL_RenderClear(engine.renderer);
     
     sx_render_recursive(engine.root, mx, my, 0, 0);
+    if (latency_overlay) _latency_draw_overlay();
     SDL_RenderPresent(engine.renderer);
+    _latency_presented();
+    in_render = 0;
 }
@@ -20,9 +20,77 @@ typedef enum {
     UI_LAYOUT_HORIZONTAL  = 1 << 4,
     UI_LAYOUT_GRID        = 1 << 5,
     UI_SCROLLABLE         = 1 << 6,
-    UI_LAYOUT_VERTICAL    = 1 << 7
+    UI_LAYOUT_VERTICAL    = 1 << 7,
+    UI_LAYOUT_FLEX        = 1 << 8,
+    UI_SCROLLABLE_X       = 1 << 9
 } UIFlags;
 
+typedef enum {
+    UI_BLIT_COPY          = 0,
+    UI_BLIT_BLEND         = 1 << 0,
+    UI_BLIT_BILINEAR      = 1 << 1
+} UIBlitFlags;
+
+typedef enum {
+    UI_FILL_NONZERO,
+    UI_FILL_EVENODD
+} UIFillRule;
+
+typedef enum {
+    UI_LAYER_BLEND_NORMAL,
+    UI_LAYER_BLEND_ADD,
+    UI_LAYER_BLEND_MULTIPLY,
+    UI_LAYER_BLEND_SCREEN
+} UILayerBlend;
+
+typedef enum {
+    UI_PARTICLE_EDGE_NONE,
+    UI_PARTICLE_EDGE_BOUNCE,
+    UI_PARTICLE_EDGE_WRAP
+} UIParticleEdge;
+
+typedef enum {
+    UI_FLEX_JUSTIFY_START,
+    UI_FLEX_JUSTIFY_CENTER,
+    UI_FLEX_JUSTIFY_END,
+    UI_FLEX_JUSTIFY_SPACE_BETWEEN,
+    UI_FLEX_JUSTIFY_SPACE_AROUND,
+    UI_FLEX_JUSTIFY_SPACE_EVENLY
+} UIFlexJustify;
+
+typedef enum {
+    UI_FLEX_ALIGN_AUTO,
+    UI_FLEX_ALIGN_START,
+    UI_FLEX_ALIGN_CENTER,
+    UI_FLEX_ALIGN_END,
+    UI_FLEX_ALIGN_STRETCH
+} UIFlexAlign;
+
+#define UI_FLEX_BASIS_AUTO -1
+
+typedef enum {
+    UI_ANCHOR_NONE        = 0,
+    UI_ANCHOR_LEFT        = 1 << 0,
+    UI_ANCHOR_TOP         = 1 << 1,
+    UI_ANCHOR_RIGHT       = 1 << 2,
+    UI_ANCHOR_BOTTOM      = 1 << 3,
+    UI_ANCHOR_CENTER_X    = 1 << 4,
+    UI_ANCHOR_CENTER_Y    = 1 << 5,
+    UI_ANCHOR_CENTER      = UI_ANCHOR_CENTER_X | UI_ANCHOR_CENTER_Y,
+    UI_ANCHOR_ALL         = UI_ANCHOR_LEFT | UI_ANCHOR_TOP | UI_ANCHOR_RIGHT | UI_ANCHOR_BOTTOM
+} UIAnchor;
+
+typedef enum {
+    UI_LATENCY_MOTION,
+    UI_LATENCY_BUTTON,
+    UI_LATENCY_WHEEL,
+    UI_LATENCY_KEY,
+    UI_LATENCY_TEXT,
+    UI_LATENCY_KINDS
+} UILatencyKind;
+
+#define UI_LATENCY_BUCKETS 16
+
 typedef enum { 
     UI_BUTTON, 
     UI_LABEL, 
@@ -31,14 +99,17 @@ typedef enum {
     UI_FRAME, 
     UI_SLIDER,
     UI_DROPDOWN,
-    UI_CANVAS
+    UI_CANVAS,
+    UI_PARTICLES
 } UIType;
 
 typedef struct UIElement UIElement;
+typedef struct UISprite UISprite;
+typedef struct UIPath UIPath;
 
 typedef struct UIConnection {
-    int id;
-    list* parent_list;
+    int slot;
+    Uint32 generation;
 } UIConnection;
 
 typedef struct {
@@ -70,6 +141,43 @@ typedef struct {
     UIRoundedCorners rounded;
 } UIEffects;
 
+typedef struct {
+    int x, y;
+    Uint32 color;
+} SXPoint;
+
+typedef struct {
+    int x1, y1, x2, y2;
+    Uint32 color;
+} SXLine;
+
+typedef struct {
+    int x, y, w, h;
+    Uint32 color;
+    int filled;
+} SXRect;
+
+typedef struct {
+    int cx, cy, radius;
+    Uint32 color;
+    int filled;
+} SXCircle;
+
+typedef struct {
+    float *x, *y, *vx, *vy, *size;
+    Uint32* color;
+    int count;
+} SXParticles;
+
+typedef struct {
+    Uint32 count;
+    float mean_ms;
+    Uint32 p50_ms, p95_ms, p99_ms;
+    Uint32 max_ms;
+    Uint32 bucket_limit_ms[UI_LATENCY_BUCKETS];
+    Uint32 buckets[UI_LATENCY_BUCKETS];
+} UILatencyStats;
+
 <<<<<<< HEAD
 typedef void (*ClickCallback)(void* element);
 typedef void (*FocusCallback)(void* element, int is_focused);
@@ -88,6 +196,8 @@ typedef void (*DropdownCallback)(void *element, int index, const char *value);
 typedef void (*FileDropCallback)(UIElement *element, const char *filepath);
 typedef void (*MouseClickCallback)(UIElement *element, int button);
 >>>>>>> 410878f (feat: Add new pages and enhance input handling)
+typedef void (*VirtualListBindCallback)(UIElement* row, int index);
+typedef void (*PostCallback)(void* userdata);
 
 // ============================================================================
 // COLOR CONSTANTS
@@ -165,6 +275,8 @@ UIElement* sxui_checkbox(UIElement* parent, const char* label);
 UIElement* sxui_slider(UIElement* parent, float initial_value);
 UIElement* sxui_dropdown(UIElement* parent, const char** options, int option_count, int default_index);
 UIElement* sxui_canvas(UIElement* parent, int x, int y, int w, int h);
+UIElement* sxui_canvas_tiled(UIElement* parent, int x, int y, int w, int h, int world_w, int world_h);
+UIElement* sxui_canvas_open_mapped(UIElement* parent, const char* path, int w, int h);
 
 UIElement* sxui_clone(UIElement* element);
 void sxui_delete(UIElement* element);
@@ -230,6 +342,7 @@ const char *sxui_get_scancode_name(int scancode);
 void sxui_get_window_size(int *w, int *h);
 int sxui_get_window_width(void);
 int sxui_get_window_height(void);
+void sxui_set_resizable(int resizable);
 
 // ============================================================================
 // PUBLIC API - EFFECTS
@@ -252,10 +365,141 @@ void sxui_canvas_draw_line(UIElement* canvas, int x1, int y1, int x2, int y2, Ui
 void sxui_canvas_draw_rect(UIElement* canvas, int x, int y, int w, int h, Uint32 color, int filled);
 void sxui_canvas_draw_circle(UIElement* canvas, int cx, int cy, int radius, Uint32 color, int filled);
 
+void sxui_canvas_draw_points(UIElement* canvas, const SXPoint* points, int count);
+void sxui_canvas_draw_lines(UIElement* canvas, const SXLine* lines, int count);
+void sxui_canvas_draw_rects(UIElement* canvas, const SXRect* rects, int count);
+void sxui_canvas_draw_circles(UIElement* canvas, const SXCircle* circles, int count);
+
+void sxui_canvas_blit(UIElement* canvas, const Uint32* src_pixels, int sw, int sh, int pitch,
+                      const SDL_Rect* dst_rect, int flags);
+UISprite* sxui_sprite_load_bmp(const char* path);
+int sxui_sprite_get_width(UISprite* sprite);
+int sxui_sprite_get_height(UISprite* sprite);
+void sxui_canvas_draw_sprite(UIElement* canvas, UISprite* sprite, const SDL_Rect* dst_rect, int flags);
+void sxui_sprite_cache_clear(void);
+
+void sxui_canvas_draw_text(UIElement* canvas, int x, int y, const char* text, Uint32 color, TTF_Font* font);
+void sxui_glyph_cache_clear(void);
+
+void sxui_canvas_set_double_buffered(UIElement* canvas, int enabled);
+int sxui_canvas_is_double_buffered(UIElement* canvas);
+void sxui_canvas_swap(UIElement* canvas);
+
+void sxui_canvas_set_scrolling(UIElement* canvas, int enabled);
+void sxui_canvas_scroll(UIElement* canvas, int columns, Uint32 background);
+int sxui_canvas_scroll_x(UIElement* canvas, int x);
+
+int sxui_canvas_add_layer(UIElement* canvas, const char* name);
+int sxui_canvas_find_layer(UIElement* canvas, const char* name);
+int sxui_canvas_get_layer_count(UIElement* canvas);
+void sxui_canvas_select_layer(UIElement* canvas, int layer);
+void sxui_canvas_set_layer_opacity(UIElement* canvas, int layer, Uint8 opacity);
+void sxui_canvas_set_layer_visible(UIElement* canvas, int layer, int visible);
+void sxui_canvas_set_layer_blend(UIElement* canvas, int layer, UILayerBlend blend);
+
+int sxui_canvas_is_tiled(UIElement* canvas);
+void sxui_canvas_set_view(UIElement* canvas, float x, float y, float zoom);
+void sxui_canvas_get_view(UIElement* canvas, float* x, float* y, float* zoom);
+void sxui_canvas_view_to_world(UIElement* canvas, int vx, int vy, float* x, float* y);
+int sxui_canvas_get_tile_count(UIElement* canvas);
+
+UIPath* sxui_path_new(void);
+void sxui_path_free(UIPath* path);
+void sxui_path_reset(UIPath* path);
+void sxui_path_move_to(UIPath* path, float x, float y);
+void sxui_path_line_to(UIPath* path, float x, float y);
+void sxui_path_quad_to(UIPath* path, float cx, float cy, float x, float y);
+void sxui_path_cubic_to(UIPath* path, float c1x, float c1y, float c2x, float c2y, float x, float y);
+void sxui_path_close(UIPath* path);
+void sxui_canvas_fill_path(UIElement* canvas, UIPath* path, Uint32 color, UIFillRule rule);
+void sxui_canvas_fill_polygon(UIElement* canvas, const SDL_FPoint* points, int count, Uint32 color, UIFillRule rule);
+void sxui_canvas_flood_fill(UIElement* canvas, int x, int y, Uint32 color, int tolerance);
+
+void sxui_canvas_set_history(UIElement* canvas, size_t budget_bytes);
+void sxui_canvas_checkpoint(UIElement* canvas);
+int sxui_canvas_undo(UIElement* canvas);
+int sxui_canvas_redo(UIElement* canvas);
+int sxui_canvas_can_undo(UIElement* canvas);
+int sxui_canvas_can_redo(UIElement* canvas);
+size_t sxui_canvas_history_bytes(UIElement* canvas);
+void sxui_canvas_sync(UIElement* canvas);
+
+// ============================================================================
+// PUBLIC API - PARTICLES
+// ============================================================================
+
+UIElement* sxui_particles(UIElement* parent, int x, int y, int w, int h);
+int sxui_particles_emit(UIElement* el, float x, float y, float vx, float vy, float size, Uint32 color);
+void sxui_particles_remove(UIElement* el, int index);
+void sxui_particles_clear(UIElement* el);
+int sxui_particles_count(UIElement* el);
+SXParticles sxui_particles_data(UIElement* el);
+void sxui_particles_update(UIElement* el, float dt);
+void sxui_particles_set_edge(UIElement* el, UIParticleEdge edge);
+void sxui_particles_set_texture(UIElement* el, SDL_Texture* texture);
+void sxui_particles_set_cell_size(UIElement* el, float cell);
+int sxui_particles_query(UIElement* el, float x, float y, float radius, int* out, int max);
+
+// ============================================================================
+// PUBLIC API - VIRTUAL LIST
+// ============================================================================
+
+UIElement* sxui_virtual_list(UIElement* parent, int row_height, int count, VirtualListBindCallback bind);
+void sxui_virtual_list_set_count(UIElement* list, int count);
+void sxui_virtual_list_set_row_height(UIElement* list, int index, int height);
+void sxui_virtual_list_refresh(UIElement* list);
+void sxui_virtual_list_scroll_to(UIElement* list, int index);
+
 // ============================================================================
 // PUBLIC API - LAYOUT CONTROL
 // ============================================================================
 
+void sxui_layout_flush(void);
+void sxui_set_flex(UIElement* el, float grow, float shrink, int basis);
+void sxui_set_min_size(UIElement* el, int w, int h);
+void sxui_set_max_size(UIElement* el, int w, int h);
+void sxui_set_align_self(UIElement* el, UIFlexAlign align);
+void sxui_frame_set_scroll_snap(UIElement* frame, int snap_x, int snap_y);
+void sxui_frame_scroll_to(UIElement* frame, int x, int y);
+void sxui_frame_fling(UIElement* frame, float vx, float vy);
+void sxui_frame_get_scroll(UIElement* frame, int* x, int* y);
+int sxui_is_scrolling(void);
+void sxui_frame_set_justify(UIElement* frame, UIFlexJustify justify);
+void sxui_frame_set_align(UIElement* frame, UIFlexAlign align);
+void sxui_set_anchors(UIElement* el, int anchors);
+void sxui_set_anchor_margins(UIElement* el, int left, int top, int right, int bottom);
+void sxui_set_percent_size(UIElement* el, float w_percent, float h_percent);
+void sxui_set_auto_size(UIElement* el, int enabled);
+void sxui_set_text_padding(UIElement* el, int pad_x, int pad_y);
+
+// ============================================================================
+// PUBLIC API - THREADING
+// ============================================================================
+
+int sxui_post(PostCallback fn, void* userdata);
+int sxui_post_set_text(UIElement* el, const char* text);
+int sxui_post_set_value(UIElement* el, float value);
+
+// ============================================================================
+// PUBLIC API - RECORDING
+// ============================================================================
+
+int sxui_record_begin(const char* path);
+void sxui_record_end(void);
+int sxui_replay(const char* path);
+int sxui_is_replaying(void);
+Uint32 sxui_get_ticks(void);
+
+// ============================================================================
+// PUBLIC API - PROFILING
+// ============================================================================
+
+void sxui_get_latency(UILatencyKind kind, UILatencyStats* out);
+void sxui_reset_latency(void);
+Uint32 sxui_get_event_timestamp(void);
+void sxui_set_low_latency(int enabled);
+void sxui_set_profiler_overlay(int enabled);
+
 <<<<<<< HEAD
 void sxui_frame_set_padding(UIElement* frame, int padding);
 void sxui_frame_set_spacing(UIElement* frame, int spacing);